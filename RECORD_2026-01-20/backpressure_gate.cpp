@@ -11,26 +11,42 @@
 //
 // ARCHITECTURE:
 // [Producers] -> [Gate (Circuit Breaker)] -> [Priority Router] -> [Worker Pool]
-//                                                  |
-//                                            [Telemetry DB]
+//                                                  |                 |     ^
+//                                            [Telemetry DB]   [IO Timer Wheel]
 //
 // KEY FEATURES:
 // 1. Lock-Free/Fine-Grained Locking queues for 4 priority levels.
 // 2. Thread-safe Asynchronous Logger (Double Buffering).
 // 3. Latency Histogram (P50, P99 calculation).
 // 4. Circuit Breaker pattern for overload protection.
-// 5. Zero-allocation hot paths where possible.
+// 5. Zero-allocation hot paths: cache-line WorkItem with inline metadata.
+// 6. Async IO completion path: IO waits park on a timer wheel, not a worker.
+// 7. Batched submit/pop: one lock and one wakeup per batch, not per item.
+// 8. Elastic worker pool sized by depth, blocked/on-CPU time and latency.
+// 9. Open-loop load generation measured from intended send time.
+// 10. Per-priority TTL: expired items are dropped at dequeue, not executed.
+// 11. Per-CPU sharded counters with a snapshot/delta API for monitoring.
+// 12. Per-producer fair admission (stochastic fair buckets per level).
+// 13. Backpressure-aware submit: producers park in FIFO order for capacity.
+// 14. Realistic CPU kernels (hash/LZ/GEMM/parse) with runtime AVX2 dispatch.
+// 15. Coalescing of duplicate ADMINISTRATIVE items via a lock-free key index.
+// 16. Bounded-time shutdown drain: urgent levels first, the rest shed in bulk.
+// 17. Cross-process submission ring in /dev/shm with futex wakeups and credits.
 // ============================================================================
 
 #include <algorithm>
 #include <atomic>
 #include <array>
 #include <barrier>
+#include <bit>
+#include <charconv>
 #include <chrono>
 #include <cmath>
 #include <condition_variable>
+#include <cstring>
 #include <deque>
 #include <format>
+#include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
@@ -43,14 +59,30 @@
 #include <random>
 #include <semaphore>
 #include <source_location>
+#include <span>
 #include <stop_token>
 #include <string>
 #include <string_view>
 #include <syncstream>
 #include <thread>
+#include <type_traits>
 #include <vector>
 #include <variant>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 // ============================================================================
 // SECTION 1: CORE UTILITIES & TYPES
 // ============================================================================
@@ -249,6 +281,10 @@ public:
         return count == 0 ? 0 : sum_.load() / count;
     }
 
+    // Raw totals, for callers that compute windowed means from deltas
+    uint64_t get_count() const { return total_count_.load(std::memory_order_relaxed); }
+    uint64_t get_sum() const { return sum_.load(std::memory_order_relaxed); }
+
 private:
     uint64_t min_val_;
     uint64_t max_val_;
@@ -259,18 +295,135 @@ private:
     std::atomic<uint64_t> sum_{0};
 };
 
+// --- Per-CPU Shard Selection ---
+// sched_getcpu() is a vDSO call but still not free, so the result is cached
+// per thread and refreshed every few hundred uses to follow migrations.
+inline size_t current_cpu_shard() {
+    thread_local size_t cached = 0;
+    thread_local uint32_t uses_left = 0;
+    if (uses_left == 0) {
+#if defined(__linux__)
+        int cpu = sched_getcpu();
+        cached = cpu >= 0 ? static_cast<size_t>(cpu)
+                          : std::hash<std::thread::id>{}(std::this_thread::get_id());
+#else
+        cached = std::hash<std::thread::id>{}(std::this_thread::get_id());
+#endif
+        uses_left = 256;
+    }
+    uses_left--;
+    return cached;
+}
+
+// --- Sharded Counter ---
+// Monotonic counter split into cache-line cells indexed by CPU. Writers
+// only touch their own CPU's line; readers sum all cells. A sum is not an
+// atomic cut across cells, but every cell only grows, so successive reads
+// never go backwards.
+class ShardedCounter {
+public:
+    static constexpr size_t kShards = 64;
+
+    void add(uint64_t n = 1) noexcept {
+        cells_[current_cpu_shard() % kShards].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t load() const noexcept {
+        uint64_t sum = 0;
+        for (const auto& cell : cells_) sum += cell.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Cell, kShards> cells_{};
+};
+
 struct SystemMetrics {
-    std::atomic<uint64_t> tasks_submitted{0};
-    std::atomic<uint64_t> tasks_rejected_queue_full{0};
-    std::atomic<uint64_t> tasks_rejected_circuit_open{0};
-    std::atomic<uint64_t> tasks_processed{0};
-    std::atomic<uint64_t> tasks_failed{0};
+    ShardedCounter tasks_submitted;
+    ShardedCounter tasks_rejected_queue_full;
+    ShardedCounter tasks_rejected_circuit_open;
+    ShardedCounter tasks_processed;
+    ShardedCounter tasks_failed;
+    // Dropped at dequeue after outliving their level's TTL; never executed
+    ShardedCounter tasks_expired;
+    // Dropped unexecuted when the shutdown drain ran out of time
+    ShardedCounter tasks_shed;
+
+    // IO items parked on the timer wheel vs. slept inline on a worker
+    ShardedCounter io_dispatched_async;
+    ShardedCounter io_blocking_fallback;
+
+    // Parked submits (submit_async / submit_until)
+    ShardedCounter admitted_after_wait;
+    ShardedCounter admission_timed_out;
+    ShardedCounter admission_failed_fast;
     
     // Latency histogram for end-to-end time (0 to 100ms)
     Histogram processing_latency_us{0, 100000, 100}; 
-    
-    // Queue depth tracking
-    std::atomic<size_t> current_queue_depth{0};
+
+    // Queueing age of items handed to workers, measured at dequeue
+    Histogram dequeue_age_us{0, 100000, 100};
+
+    // Worker pool size (changes only when autoscaling is enabled)
+    std::atomic<size_t> active_workers{0};
+    std::atomic<uint64_t> pool_grow_events{0};
+    std::atomic<uint64_t> pool_shrink_events{0};
+};
+
+// Point-in-time copy of the counters plus the gauges that live elsewhere
+// (queue depth is read from the router, not mirrored on every submit).
+// Downstream counters are read before upstream ones, so relations such as
+// processed + failed + expired <= submitted hold within one snapshot.
+struct MetricsSnapshot {
+    uint64_t taken_at_ns = 0;
+
+    uint64_t tasks_processed = 0;
+    uint64_t tasks_failed = 0;
+    uint64_t tasks_expired = 0;
+    uint64_t tasks_evicted = 0;
+    uint64_t tasks_coalesced = 0; // Accepted, merged into a queued duplicate
+    uint64_t tasks_shed = 0;
+    uint64_t io_dispatched_async = 0;
+    uint64_t io_blocking_fallback = 0;
+    uint64_t admitted_after_wait = 0;
+    uint64_t admission_timed_out = 0;
+    uint64_t admission_failed_fast = 0;
+    uint64_t tasks_submitted = 0;
+    uint64_t tasks_rejected_queue_full = 0;
+    uint64_t tasks_rejected_circuit_open = 0;
+    uint64_t tasks_rejected_fairness = 0; // Subset of queue_full
+
+    size_t queue_depth = 0;
+    size_t borrowed_slots = 0;
+    size_t active_workers = 0;
+
+    // Counter deltas over (prev, this]; gauges keep this snapshot's value
+    MetricsSnapshot delta_since(const MetricsSnapshot& prev) const {
+        MetricsSnapshot d = *this;
+        d.tasks_processed -= prev.tasks_processed;
+        d.tasks_failed -= prev.tasks_failed;
+        d.tasks_expired -= prev.tasks_expired;
+        d.tasks_evicted -= prev.tasks_evicted;
+        d.tasks_coalesced -= prev.tasks_coalesced;
+        d.tasks_shed -= prev.tasks_shed;
+        d.io_dispatched_async -= prev.io_dispatched_async;
+        d.io_blocking_fallback -= prev.io_blocking_fallback;
+        d.admitted_after_wait -= prev.admitted_after_wait;
+        d.admission_timed_out -= prev.admission_timed_out;
+        d.admission_failed_fast -= prev.admission_failed_fast;
+        d.tasks_submitted -= prev.tasks_submitted;
+        d.tasks_rejected_queue_full -= prev.tasks_rejected_queue_full;
+        d.tasks_rejected_circuit_open -= prev.tasks_rejected_circuit_open;
+        d.tasks_rejected_fairness -= prev.tasks_rejected_fairness;
+        d.taken_at_ns -= prev.taken_at_ns;
+        return d;
+    }
+
+    // For a delta: the window length in seconds
+    double window_s() const { return taken_at_ns / 1e9; }
 };
 
 // ============================================================================
@@ -285,24 +438,64 @@ enum class Priority : uint8_t {
     COUNT    = 4
 };
 
-enum class TaskType {
+enum class TaskType : uint8_t {
     CPU_INTENSIVE,
     IO_BOUND,
     ADMINISTRATIVE
 };
 
+// --- Fixed-capacity string stored inline (no heap) ---
+// Longer input is truncated; metadata is diagnostic, not a key.
+template <size_t Capacity>
+class InlineString {
+    static_assert(Capacity < 256, "length is stored in one byte");
+public:
+    InlineString() = default;
+    InlineString(std::string_view sv) { assign(sv); }
+
+    InlineString& operator=(std::string_view sv) {
+        assign(sv);
+        return *this;
+    }
+
+    void assign(std::string_view sv) noexcept {
+        len_ = static_cast<uint8_t>(std::min(sv.size(), Capacity));
+        std::memcpy(data_, sv.data(), len_);
+    }
+
+    std::string_view view() const noexcept { return {data_, len_}; }
+    size_t size() const noexcept { return len_; }
+    static constexpr size_t capacity() noexcept { return Capacity; }
+
+private:
+    uint8_t len_ = 0;
+    char data_[Capacity];
+};
+
 struct TaskPayload {
-    TaskType type;
     uint32_t complexity_score; // 0-1000
-    std::string metadata;
+    TaskType type;
+    InlineString<23> metadata;
 };
 
-struct WorkItem {
+// One cache line per item: ring slots never share a line and submitting
+// an item never touches the allocator. Move-only so ownership transfer
+// through the router stays explicit.
+struct alignas(64) WorkItem {
     uint64_t id;
-    Priority priority;
     uint64_t created_at_ns;
     TaskPayload payload;
     uint32_t producer_id;
+    Priority priority;
+    // ADMINISTRATIVE items with the same nonzero key merge while queued
+    // (see PriorityRouter::CapacityPolicy::coalesce). 0 = never merge.
+    uint64_t coalesce_key = 0;
+
+    WorkItem() = default;
+    WorkItem(WorkItem&&) noexcept = default;
+    WorkItem& operator=(WorkItem&&) noexcept = default;
+    WorkItem(const WorkItem&) = delete;
+    WorkItem& operator=(const WorkItem&) = delete;
 
     // Helper to calculate age
     uint64_t age_us() const {
@@ -310,27 +503,135 @@ struct WorkItem {
     }
 };
 
+static_assert(sizeof(WorkItem) == 64, "WorkItem must fit one cache line");
+static_assert(std::is_nothrow_move_constructible_v<WorkItem>);
+
 // ============================================================================
 // SECTION 5: MULTI-LEVEL PRIORITY QUEUE
 // ============================================================================
 
+enum class DequeuePolicy {
+    STRICT,           // Always drain the highest non-empty level first
+    WEIGHTED_DEFICIT  // Deficit round-robin over levels by configured share
+};
+
 class PriorityRouter {
 public:
-    explicit PriorityRouter(size_t base_capacity) {
+    static constexpr size_t kLevels = static_cast<size_t>(Priority::COUNT);
+
+    struct Policy {
+        DequeuePolicy mode = DequeuePolicy::STRICT;
+        // Items each level may dequeue per DRR round (CRITICAL..LOW).
+        std::array<uint32_t, kLevels> quanta = {8, 4, 2, 1};
+        // LOW is guaranteed at least low_floor / sum(quanta) of pops under
+        // saturation, whatever the configured quanta say.
+        uint32_t low_floor = 1;
+        // Max queueing age per level in microseconds (0 = never expires).
+        // Items past it are dropped at dequeue instead of being returned.
+        std::array<uint64_t, kLevels> ttl_us = {0, 0, 0, 0};
+    };
+
+    // Fixed mode keeps each level at its nominal capacity. Shared mode keeps
+    // the same total budget but reserves only a floor per level; the rest is
+    // a common pool that levels borrow from up to their ceiling and return
+    // on pop. With reclaim, a level that finds the pool empty evicts the
+    // newest borrowed item of the lowest lower-priority level to take over
+    // its slot. Items held never exceed the budget.
+    struct CapacityPolicy {
+        bool shared = false;
+        double floor_fraction = 0.5; // Of nominal capacity, reserved per level
+        double ceiling_factor = 4.0; // Of nominal capacity, hard cap per level
+        bool reclaim = true;
+
+        // Stochastic fair admission: producers hash into fair_buckets per
+        // level, and once a level is fair_engage_fraction full a bucket may
+        // hold at most its equal share of what the level can reach. Below
+        // that, or while only one bucket has items queued, any producer may
+        // use the free space (work-conserving).
+        bool per_producer_fair = false;
+        uint32_t fair_buckets = 16;
+        double fair_engage_fraction = 0.5;
+
+        // An ADMINISTRATIVE item whose coalesce_key is already queued at its
+        // level is merged into that item: accepted, but it takes no slot and
+        // runs no extra time. Merged duplicates share the queued item's fate
+        // (TTL expiry, eviction).
+        bool coalesce = false;
+    };
+
+    explicit PriorityRouter(size_t base_capacity)
+        : PriorityRouter(base_capacity, Policy{}, CapacityPolicy{}) {}
+
+    PriorityRouter(size_t base_capacity, Policy policy)
+        : PriorityRouter(base_capacity, policy, CapacityPolicy{}) {}
+
+    PriorityRouter(size_t base_capacity, Policy policy, CapacityPolicy capacity)
+        : policy_(policy), capacity_policy_(capacity) {
+        // A zero quantum would starve its level forever; clamp to one slot.
+        for (auto& q : policy_.quanta) q = std::max<uint32_t>(q, 1);
+        auto& low_q = policy_.quanta[static_cast<size_t>(Priority::LOW)];
+        low_q = std::max(low_q, policy_.low_floor);
+        has_ttl_ = std::ranges::any_of(policy_.ttl_us, [](uint64_t ttl) { return ttl != 0; });
+
         // Configure capacities based on priority logic
         // Critical queue is smaller but higher priority
-        queues_[0] = std::make_unique<BoundedQueue>(base_capacity / 4); // Critical
-        queues_[1] = std::make_unique<BoundedQueue>(base_capacity / 2); // High
-        queues_[2] = std::make_unique<BoundedQueue>(base_capacity);     // Normal
-        queues_[3] = std::make_unique<BoundedQueue>(base_capacity * 2); // Low
+        const std::array<size_t, kLevels> nominal = {
+            base_capacity / 4, // Critical
+            base_capacity / 2, // High
+            base_capacity,     // Normal
+            base_capacity * 2  // Low
+        };
+
+        budget_ = std::accumulate(nominal.begin(), nominal.end(), size_t{0});
+
+        if (capacity_policy_.per_producer_fair) {
+            uint64_t salt = std::random_device{}();
+            for (auto& fair : fair_) {
+                fair = std::make_unique<FairShare>(capacity_policy_.fair_buckets,
+                                                   capacity_policy_.fair_engage_fraction, salt);
+            }
+        }
+
+        if (!capacity_policy_.shared) {
+            for (size_t i = 0; i < kLevels; ++i) {
+                if (capacity_policy_.coalesce) coalesce_[i] = std::make_unique<CoalesceIndex>(nominal[i]);
+                queues_[i] = std::make_unique<BoundedQueue>(nominal[i], nominal[i], nullptr,
+                                                            fair_[i].get(), coalesce_[i].get());
+            }
+            return;
+        }
+
+        std::array<size_t, kLevels> floors{};
+        size_t budget = 0, reserved = 0;
+        for (size_t i = 0; i < kLevels; ++i) {
+            floors[i] = static_cast<size_t>(nominal[i] * std::clamp(capacity_policy_.floor_fraction, 0.0, 1.0));
+            budget += nominal[i];
+            reserved += floors[i];
+        }
+
+        pool_slots_ = budget - reserved;
+        pool_ = std::make_unique<SlotPool>(pool_slots_);
+        for (size_t i = 0; i < kLevels; ++i) {
+            size_t ceiling = static_cast<size_t>(nominal[i] * std::max(capacity_policy_.ceiling_factor, 1.0));
+            ceiling = std::clamp(ceiling, std::max<size_t>(floors[i], 1), floors[i] + pool_slots_);
+            if (capacity_policy_.coalesce) coalesce_[i] = std::make_unique<CoalesceIndex>(ceiling);
+            queues_[i] = std::make_unique<BoundedQueue>(floors[i], ceiling, pool_.get(),
+                                                        fair_[i].get(), coalesce_[i].get());
+        }
     }
 
-    // Returns true if enqueued, false if full
-    bool try_push(WorkItem&& item) {
-        int prio_idx = static_cast<int>(item.priority);
-        bool success = queues_[prio_idx]->try_push(std::move(item));
-        
-        if (success) {
+    // Returns true if enqueued, false if full. An item merged into a
+    // queued duplicate also returns true and sets *merged when given.
+    bool try_push(WorkItem&& item, bool* merged = nullptr) {
+        size_t prio_idx = static_cast<size_t>(item.priority);
+        PushResult result = push_level(prio_idx, std::move(item));
+
+        if (result == PushResult::MERGED) {
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            if (merged != nullptr) *merged = true;
+            return true;
+        }
+        if (result == PushResult::OK) {
              // Signal that work is available
              total_items_.fetch_add(1, std::memory_order_release);
              return true;
@@ -338,77 +639,630 @@ public:
         return false;
     }
 
-    // Try to pop the highest priority item available
-    std::optional<WorkItem> try_pop() {
+    // Try to pop the highest priority item available. Expired items met
+    // on the way are dropped and added to *expired when given.
+    std::optional<WorkItem> try_pop(size_t* expired = nullptr) {
         if (total_items_.load(std::memory_order_acquire) == 0) {
             return std::nullopt;
         }
 
-        // Strict Priority Scheduling: Check 0, then 1, then 2, then 3
-        for (int i = 0; i < static_cast<int>(Priority::COUNT); ++i) {
-            auto item = queues_[i]->pop();
-            if (item.has_value()) {
-                total_items_.fetch_sub(1, std::memory_order_release);
-                return item;
+        Expiry expiry = make_expiry();
+        auto item = weighted()
+                        ? pop_weighted(expiry)
+                        : pop_strict(expiry);
+        size_t removed = (item.has_value() ? 1 : 0) + expiry.dropped;
+        if (removed > 0) {
+            total_items_.fetch_sub(removed, std::memory_order_release);
+        }
+        if (expired != nullptr) *expired += expiry.dropped;
+        return item;
+    }
+
+    // Enqueues items in order, one queue lock per run of equal priority.
+    // Stops at the first item that does not fit and returns how many were
+    // taken, so the caller can retry the remaining suffix. Taken items that
+    // merged into queued duplicates are added to *merged when given.
+    size_t try_push_batch(std::span<WorkItem> items, size_t* merged = nullptr) {
+        size_t accepted = 0, coalesced = 0;
+        while (accepted < items.size()) {
+            Priority prio = items[accepted].priority;
+            size_t run = accepted + 1;
+            while (run < items.size() && items[run].priority == prio) ++run;
+
+            auto slice = items.subspan(accepted, run - accepted);
+            size_t lvl = static_cast<size_t>(prio);
+            PushResult stopped;
+            size_t pushed = queues_[lvl]->try_push_batch(slice, coalesced, stopped);
+            // Out of room: fall back to per-item pushes that may reclaim. A
+            // producer over its share is refused (and counted) just once.
+            while (stopped == PushResult::FULL && pushed < slice.size()) {
+                PushResult result = push_level(lvl, std::move(slice[pushed]));
+                if (result == PushResult::MERGED) coalesced++;
+                else if (result != PushResult::OK) break;
+                ++pushed;
             }
+            accepted += pushed;
+            if (pushed < slice.size()) break;
         }
-        return std::nullopt;
+
+        if (accepted > coalesced) total_items_.fetch_add(accepted - coalesced, std::memory_order_release);
+        if (coalesced > 0) coalesced_.fetch_add(coalesced, std::memory_order_relaxed);
+        if (merged != nullptr) *merged += coalesced;
+        return accepted;
+    }
+
+    // Appends up to `max` items to `out`, split across levels the same way
+    // repeated try_pop calls would split them, but taking each level's
+    // share under a single queue lock. Expired items do not count
+    // towards `max`; they are dropped and added to *expired when given.
+    size_t try_pop_batch(std::vector<WorkItem>& out, size_t max, size_t* expired = nullptr) {
+        if (max == 0 || total_items_.load(std::memory_order_acquire) == 0) return 0;
+
+        Expiry expiry = make_expiry();
+        size_t taken = weighted()
+                           ? pop_batch_weighted(out, max, expiry)
+                           : pop_batch_strict(out, max, expiry);
+        size_t removed = taken + expiry.dropped;
+        if (removed > 0) total_items_.fetch_sub(removed, std::memory_order_release);
+        if (expired != nullptr) *expired += expiry.dropped;
+        return taken;
+    }
+
+    const Policy& policy() const { return policy_; }
+
+    // Items dropped from lower levels so a higher level could reclaim a slot
+    uint64_t evicted() const { return evicted_.load(std::memory_order_relaxed); }
+
+    // Pushes merged into an already-queued item with the same coalesce key
+    uint64_t coalesced() const { return coalesced_.load(std::memory_order_relaxed); }
+
+    // Shared-pool slots currently lent out (0 in fixed mode)
+    size_t borrowed_slots() const { return pool_ ? pool_slots_ - pool_->available() : 0; }
+
+    // Pushes refused because the producer's bucket was over its share
+    uint64_t fairness_rejects() const {
+        uint64_t sum = 0;
+        for (const auto& fair : fair_) {
+            if (fair) sum += fair->rejected();
+        }
+        return sum;
     }
 
     size_t total_size() const {
         return total_items_.load(std::memory_order_relaxed);
     }
+
+    // Free slots in the overall budget. An estimate: per-level limits and
+    // fairness may still refuse an item when this is nonzero.
+    size_t headroom() const {
+        size_t held = total_items_.load(std::memory_order_relaxed);
+        return held < budget_ ? budget_ - held : 0;
+    }
+
+    // Free slots one level could take, within the overall budget. The same
+    // kind of estimate as headroom().
+    size_t headroom(Priority p) const {
+        return std::min(headroom(), queues_[static_cast<size_t>(p)]->room());
+    }
     
     size_t size_at_priority(Priority p) const {
         return queues_[static_cast<int>(p)]->size();
     }
 
+    // Overrides a WEIGHTED_DEFICIT policy with strict priority order, e.g.
+    // so a shutdown drain finishes the most urgent levels first
+    void force_strict(bool on) { force_strict_.store(on, std::memory_order_relaxed); }
+
+    // Drops everything queued at one level in one pass; returns the count
+    size_t shed(Priority p) {
+        size_t dropped = queues_[static_cast<size_t>(p)]->clear();
+        if (dropped > 0) total_items_.fetch_sub(dropped, std::memory_order_release);
+        return dropped;
+    }
+
 private:
+    enum class PushResult { OK, FULL, OVER_SHARE, MERGED };
+
+    bool weighted() const {
+        return policy_.mode == DequeuePolicy::WEIGHTED_DEFICIT &&
+               !force_strict_.load(std::memory_order_relaxed);
+    }
+
+    // Enqueues at one level, reclaiming a borrowed slot from a lower
+    // priority level if the shared pool is dry. Each lower level gives up at
+    // most one item per call, lowest priority first. The item is only moved
+    // from on OK or MERGED.
+    PushResult push_level(size_t lvl, WorkItem&& item) {
+        auto& queue = *queues_[lvl];
+        PushResult result = queue.try_push(std::move(item));
+        if (result != PushResult::FULL) return result;
+        // Over-share producers never get to evict anyone else's work, so
+        // only FULL goes on to reclaim
+        if (!pool_ || !capacity_policy_.reclaim || !queue.can_borrow()) return result;
+
+        for (size_t victim = kLevels - 1; victim > lvl; --victim) {
+            if (!queues_[victim]->evict_borrowed()) continue;
+            total_items_.fetch_sub(1, std::memory_order_release);
+            evicted_.fetch_add(1, std::memory_order_relaxed);
+            result = queue.try_push(std::move(item));
+            if (result != PushResult::FULL) return result;
+        }
+        return result;
+    }
+
+    // Per-call expiry state threaded through the pop helpers
+    struct Expiry {
+        std::array<uint64_t, kLevels> cutoff_ns{}; // Created before this = expired
+        size_t dropped = 0;
+    };
+
+    // One clock read per pop, and none at all when no level has a TTL
+    Expiry make_expiry() const {
+        Expiry expiry;
+        if (!has_ttl_) return expiry;
+
+        uint64_t now = now_ns();
+        for (size_t i = 0; i < kLevels; ++i) {
+            uint64_t ttl_ns = policy_.ttl_us[i] * 1000;
+            if (ttl_ns != 0 && now > ttl_ns) expiry.cutoff_ns[i] = now - ttl_ns;
+        }
+        return expiry;
+    }
+
+    // Strict Priority Scheduling: Check 0, then 1, then 2, then 3
+    std::optional<WorkItem> pop_strict(Expiry& expiry) {
+        for (size_t i = 0; i < kLevels; ++i) {
+            auto item = queues_[i]->pop(expiry.cutoff_ns[i], expiry.dropped);
+            if (item.has_value()) return item;
+        }
+        return std::nullopt;
+    }
+
+    // Deficit Round-Robin with unit cost per item. The cursor stays on a
+    // level until its quantum is spent or it runs dry; an empty level
+    // forfeits its remaining deficit. At most kLevels visits per call, so
+    // a pop is O(1) regardless of queue depth. drr_lock_ only covers the
+    // credit bookkeeping; the pop itself runs under the level's own lock,
+    // so consumers on different levels do not serialize.
+    std::optional<WorkItem> pop_weighted(Expiry& expiry) {
+        for (size_t visits = 0; visits < kLevels; ++visits) {
+            size_t lvl;
+            claim_credits(1, lvl);
+
+            auto item = queues_[lvl]->pop(expiry.cutoff_ns[lvl], expiry.dropped);
+            if (item.has_value()) return item;
+
+            forfeit(lvl);
+        }
+        return std::nullopt;
+    }
+
+    size_t pop_batch_strict(std::vector<WorkItem>& out, size_t max, Expiry& expiry) {
+        size_t taken = 0;
+        for (size_t i = 0; i < kLevels && taken < max; ++i) {
+            taken += queues_[i]->pop_batch(out, max - taken, expiry.cutoff_ns[i], expiry.dropped);
+        }
+        return taken;
+    }
+
+    // Same DRR walk as pop_weighted, but a visit takes as much of the
+    // level's remaining deficit as the batch has room for. Gives up after
+    // a full cycle of empty levels.
+    size_t pop_batch_weighted(std::vector<WorkItem>& out, size_t max, Expiry& expiry) {
+        size_t taken = 0;
+        size_t empty_visits = 0;
+        while (taken < max && empty_visits < kLevels) {
+            size_t lvl;
+            size_t want = claim_credits(max - taken, lvl);
+            size_t got = queues_[lvl]->pop_batch(out, want, expiry.cutoff_ns[lvl], expiry.dropped);
+            taken += got;
+
+            // A short pop means the level ran dry; it forfeits the rest
+            if (got < want) forfeit(lvl);
+            empty_visits = got == 0 ? empty_visits + 1 : 0;
+        }
+        return taken;
+    }
+
+    // Takes up to `max` credits from the level under the cursor, refilling
+    // its quantum first if it was spent. The cursor moves on once the
+    // level's deficit reaches zero; otherwise the next claim stays here.
+    size_t claim_credits(size_t max, size_t& lvl) {
+        std::lock_guard<SpinLock> lock(drr_lock_);
+        lvl = drr_cursor_;
+        if (deficit_[lvl] == 0) deficit_[lvl] = policy_.quanta[lvl];
+
+        uint32_t grant = static_cast<uint32_t>(std::min<size_t>(deficit_[lvl], max));
+        deficit_[lvl] -= grant;
+        if (deficit_[lvl] == 0) drr_cursor_ = (lvl + 1) % kLevels;
+        return grant;
+    }
+
+    // Drops a level's unused credits after a pop found it short. A no-op
+    // if another consumer has already moved the cursor past it.
+    void forfeit(size_t lvl) {
+        std::lock_guard<SpinLock> lock(drr_lock_);
+        if (drr_cursor_ != lvl) return;
+        deficit_[lvl] = 0;
+        drr_cursor_ = (lvl + 1) % kLevels;
+    }
+
+    // --- Shared Slot Budget ---
+    // Free slots above the per-level floors. Levels take slots on push
+    // and hand them back as soon as they drain below the borrowed level.
+    class SlotPool {
+    public:
+        explicit SlotPool(size_t slots) : free_(slots) {}
+
+        // Grants up to n slots; returns how many were granted.
+        size_t acquire_up_to(size_t n) {
+            size_t free = free_.load(std::memory_order_relaxed);
+            while (free > 0) {
+                size_t take = std::min(n, free);
+                if (free_.compare_exchange_weak(free, free - take, std::memory_order_acq_rel)) {
+                    return take;
+                }
+            }
+            return 0;
+        }
+
+        void release(size_t n) { free_.fetch_add(n, std::memory_order_acq_rel); }
+        size_t available() const { return free_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<size_t> free_;
+    };
+
+    // --- Stochastic Fair Share (per level) ---
+    // Occupancy per producer hash bucket. Distinct producers may share a
+    // bucket (and its share); the random salt keeps that from being
+    // predictable. Only touched under the owning queue's lock.
+    class FairShare {
+    public:
+        FairShare(uint32_t buckets, double engage_fraction, uint64_t salt)
+            : counts_(std::max<uint32_t>(buckets, 1), 0),
+              engage_fraction_(std::clamp(engage_fraction, 0.0, 1.0)),
+              salt_(salt) {}
+
+        // `reachable` is what the level could hold right now. With other
+        // buckets queued, the share is computed as if one more producer were
+        // active, leaving headroom for the next one to show up. A bucket
+        // that is alone borrows everything but one bucket's worth of slots,
+        // which stays free so a newcomer can get in; from then on the two
+        // split the level and the borrower has to drain down to its half.
+        bool admit(uint32_t producer, size_t level_size, size_t reachable) {
+            if (level_size < static_cast<size_t>(reachable * engage_fraction_)) return true;
+
+            uint32_t count = counts_[bucket(producer)];
+            size_t share;
+            if (active_ == 1 && count != 0) {
+                share = reachable - std::max<size_t>(1, reachable / counts_.size());
+            } else {
+                size_t sharers = active_ + 1;
+                share = (reachable + sharers - 1) / sharers;
+            }
+            share = std::max<size_t>(1, share);
+            if (count < share) return true;
+
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        void on_enqueue(uint32_t producer) {
+            if (counts_[bucket(producer)]++ == 0) active_++;
+        }
+
+        void on_dequeue(uint32_t producer) {
+            if (--counts_[bucket(producer)] == 0) active_--;
+        }
+
+        uint64_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+
+    private:
+        size_t bucket(uint32_t producer) const {
+            uint64_t h = (producer ^ salt_) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(h >> 32) % counts_.size();
+        }
+
+        std::vector<uint32_t> counts_;
+        size_t active_ = 0; // Buckets with at least one queued item
+        double engage_fraction_;
+        uint64_t salt_;
+        std::atomic<uint64_t> rejected_{0};
+    };
+
+    // --- Coalescing Key Index (per level) ---
+    // Keys of the coalescable items queued at one level, in an open-
+    // addressing table sized for the level's ceiling (load <= 1/2, never
+    // grows). Lookups are lock-free, so a burst of duplicates is absorbed
+    // without touching the queue lock. Inserts and erases run under the
+    // owning queue's lock (single writer) with backward-shift deletion; a
+    // lookup racing an erase may miss, and the caller re-checks under the
+    // lock before inserting.
+    class CoalesceIndex {
+    public:
+        explicit CoalesceIndex(size_t max_items)
+            : mask_(std::bit_ceil(std::max<size_t>(2 * max_items, 16)) - 1), slots_(mask_ + 1) {}
+
+        static bool eligible(const WorkItem& item) {
+            return item.coalesce_key != 0 && item.payload.type == TaskType::ADMINISTRATIVE;
+        }
+
+        bool contains(uint64_t key) const {
+            for (size_t i = home(key);; i = (i + 1) & mask_) {
+                uint64_t found = slots_[i].load(std::memory_order_acquire);
+                if (found == key) return true;
+                if (found == 0) return false;
+            }
+        }
+
+        // Writer only; key must be absent
+        void insert(uint64_t key) {
+            size_t i = home(key);
+            while (slots_[i].load(std::memory_order_relaxed) != 0) i = (i + 1) & mask_;
+            slots_[i].store(key, std::memory_order_release);
+        }
+
+        // Writer only
+        void erase(uint64_t key) {
+            size_t hole = home(key);
+            while (true) {
+                uint64_t found = slots_[hole].load(std::memory_order_relaxed);
+                if (found == 0) return;
+                if (found == key) break;
+                hole = (hole + 1) & mask_;
+            }
+            // Pull later entries of the probe run back into the hole
+            for (size_t j = (hole + 1) & mask_;; j = (j + 1) & mask_) {
+                uint64_t moved = slots_[j].load(std::memory_order_relaxed);
+                if (moved == 0) break;
+                if (((j - home(moved)) & mask_) >= ((j - hole) & mask_)) {
+                    slots_[hole].store(moved, std::memory_order_release);
+                    hole = j;
+                }
+            }
+            slots_[hole].store(0, std::memory_order_release);
+        }
+
+    private:
+        size_t home(uint64_t key) const {
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+        }
+
+        size_t mask_;
+        std::vector<std::atomic<uint64_t>> slots_; // 0 = empty
+    };
+
     // --- Internal Bounded Queue Class ---
     // (Nested to ensure it's only used by Router)
+    // The ring is sized to the level's ceiling; limit_ is what the level may
+    // hold right now: its floor plus whatever it has borrowed from the pool.
     class BoundedQueue {
     public:
-        explicit BoundedQueue(size_t cap) 
-            : capacity_(cap), head_(0), tail_(0), size_(0) {
-            buffer_.resize(cap);
+        BoundedQueue(size_t floor, size_t ceiling, SlotPool* pool, FairShare* fair, CoalesceIndex* coalesce)
+            : capacity_(ceiling), floor_(floor), limit_(floor),
+              head_(0), tail_(0), size_(0), pool_(pool), fair_(fair), coalesce_(coalesce) {
+            buffer_.resize(ceiling);
         }
 
-        bool try_push(WorkItem&& item) {
+        PushResult try_push(WorkItem&& item) {
+            bool keyed = coalesce_ && CoalesceIndex::eligible(item);
+            // Duplicate bursts stop here, before the lock
+            if (keyed && coalesce_->contains(item.coalesce_key)) return PushResult::MERGED;
+
             std::lock_guard<SpinLock> lock(lock_);
-            if (size_ >= capacity_) return false;
+            if (keyed && coalesce_->contains(item.coalesce_key)) return PushResult::MERGED;
+            if (fair_ && !fair_->admit(item.producer_id, size_, reachable_locked())) {
+                return PushResult::OVER_SHARE;
+            }
+            if (size_ >= limit_ && borrow_locked(1) == 0) return PushResult::FULL;
             
+            if (fair_) fair_->on_enqueue(item.producer_id);
+            if (keyed) coalesce_->insert(item.coalesce_key);
             buffer_[tail_] = std::move(item);
             tail_ = (tail_ + 1) % capacity_;
             size_++;
-            return true;
+            return PushResult::OK;
         }
 
-        std::optional<WorkItem> pop() {
+        // Items created before cutoff_ns are dropped from the head first and
+        // counted into `expired`; they never reach the caller.
+        std::optional<WorkItem> pop(uint64_t cutoff_ns, size_t& expired) {
             // Optimistic check before lock
             if (size_ == 0) return std::nullopt; 
 
             std::lock_guard<SpinLock> lock(lock_);
-            if (size_ == 0) return std::nullopt;
+            expired += expire_head_locked(cutoff_ns);
+            if (size_ == 0) {
+                return_surplus_locked();
+                return std::nullopt;
+            }
 
             WorkItem item = std::move(buffer_[head_]);
+            if (fair_) fair_->on_dequeue(item.producer_id);
+            release_key_locked(item);
             head_ = (head_ + 1) % capacity_;
             size_--;
+            return_surplus_locked();
             return item;
         }
 
+        // Moves the longest prefix that fits; returns how many were taken.
+        // Taken items that merged into a queued duplicate (including one
+        // earlier in the same batch) are counted into `merged`. `stopped`
+        // says why the rest were left: FULL or OVER_SHARE, else OK.
+        size_t try_push_batch(std::span<WorkItem> items, size_t& merged, PushResult& stopped) {
+            std::lock_guard<SpinLock> lock(lock_);
+            stopped = PushResult::OK;
+            size_t room = limit_ - size_;
+            if (items.size() > room) borrow_locked(items.size() - room);
+
+            size_t n = 0;
+            for (; n < items.size(); ++n) {
+                WorkItem& item = items[n];
+                bool keyed = coalesce_ && CoalesceIndex::eligible(item);
+                if (keyed && coalesce_->contains(item.coalesce_key)) {
+                    merged++;
+                    continue;
+                }
+                if (size_ >= limit_) {
+                    stopped = PushResult::FULL;
+                    break;
+                }
+                if (fair_) {
+                    if (!fair_->admit(item.producer_id, size_, reachable_locked())) {
+                        stopped = PushResult::OVER_SHARE;
+                        break;
+                    }
+                    fair_->on_enqueue(item.producer_id);
+                }
+                if (keyed) coalesce_->insert(item.coalesce_key);
+                buffer_[tail_] = std::move(item);
+                tail_ = (tail_ + 1) % capacity_;
+                size_++;
+            }
+            // Hand back slots borrowed for items that merged or were refused
+            return_surplus_locked();
+            return n;
+        }
+
+        size_t pop_batch(std::vector<WorkItem>& out, size_t max,
+                         uint64_t cutoff_ns, size_t& expired) {
+            if (size_ == 0) return 0;
+
+            std::lock_guard<SpinLock> lock(lock_);
+            expired += expire_head_locked(cutoff_ns);
+            size_t n = std::min(max, size_);
+            for (size_t i = 0; i < n; ++i) {
+                if (fair_) fair_->on_dequeue(buffer_[head_].producer_id);
+                release_key_locked(buffer_[head_]);
+                out.push_back(std::move(buffer_[head_]));
+                head_ = (head_ + 1) % capacity_;
+            }
+            size_ -= n;
+            return_surplus_locked();
+            return n;
+        }
+
+        // Drops the newest item if it occupies a borrowed slot and returns
+        // that slot to the pool. Newest-first keeps the items closest to
+        // service, which have already paid most of their queueing delay.
+        bool evict_borrowed() {
+            if (pool_ == nullptr || size_ <= floor_) return false;
+
+            std::lock_guard<SpinLock> lock(lock_);
+            if (size_ <= floor_) return false;
+
+            tail_ = (tail_ + capacity_ - 1) % capacity_;
+            if (fair_) fair_->on_dequeue(buffer_[tail_].producer_id);
+            release_key_locked(buffer_[tail_]);
+            buffer_[tail_] = WorkItem{};
+            size_--;
+            return_surplus_locked();
+            return true;
+        }
+
+        size_t clear() {
+            std::lock_guard<SpinLock> lock(lock_);
+            size_t dropped = size_;
+            while (size_ > 0) {
+                if (fair_) fair_->on_dequeue(buffer_[head_].producer_id);
+                release_key_locked(buffer_[head_]);
+                buffer_[head_] = WorkItem{};
+                head_ = (head_ + 1) % capacity_;
+                size_--;
+            }
+            return_surplus_locked();
+            return dropped;
+        }
+
+        // Hint only: whether this level is below its ceiling
+        bool can_borrow() const { return pool_ != nullptr && limit_ < capacity_; }
+
+        // Free slots at this level, counting what it could borrow. A hint:
+        // stale as soon as the lock is released.
+        size_t room() {
+            std::lock_guard<SpinLock> lock(lock_);
+            size_t reachable = reachable_locked();
+            return reachable > size_ ? reachable - size_ : 0;
+        }
+
         size_t size() const { return size_; }
 
     private:
+        // Bulk-drops stale items from the head. Arrival order is close to
+        // creation order, so scanning stops at the first live item; a stale
+        // item stuck behind a fresh one goes at the next pop.
+        size_t expire_head_locked(uint64_t cutoff_ns) {
+            size_t dropped = 0;
+            while (size_ > 0 && buffer_[head_].created_at_ns < cutoff_ns) {
+                if (fair_) fair_->on_dequeue(buffer_[head_].producer_id);
+                release_key_locked(buffer_[head_]);
+                head_ = (head_ + 1) % capacity_;
+                size_--;
+                dropped++;
+            }
+            return dropped;
+        }
+
+        // A keyed item leaving the queue (popped, expired or evicted) frees
+        // its key, so the next duplicate queues a fresh run
+        void release_key_locked(const WorkItem& item) {
+            if (coalesce_ && CoalesceIndex::eligible(item)) coalesce_->erase(item.coalesce_key);
+        }
+
+        // What this level could hold right now: its limit plus free pool
+        size_t reachable_locked() const {
+            size_t pool_free = pool_ ? pool_->available() : 0;
+            return std::min(capacity_, limit_ + pool_free);
+        }
+
+        size_t borrow_locked(size_t n) {
+            if (pool_ == nullptr) return 0;
+            size_t granted = pool_->acquire_up_to(std::min(n, capacity_ - limit_));
+            limit_ += granted;
+            return granted;
+        }
+
+        void return_surplus_locked() {
+            size_t keep = std::max(floor_, size_);
+            if (pool_ != nullptr && limit_ > keep) {
+                pool_->release(limit_ - keep);
+                limit_ = keep;
+            }
+        }
+
         size_t capacity_;
+        size_t floor_;
+        size_t limit_;
         std::vector<WorkItem> buffer_;
         size_t head_;
         size_t tail_;
         size_t size_;
         SpinLock lock_;
+        SlotPool* pool_;
+        FairShare* fair_; // Null when fair admission is off
+        CoalesceIndex* coalesce_; // Null when coalescing is off
     };
 
-    std::array<std::unique_ptr<BoundedQueue>, 4> queues_;
+    Policy policy_;
+    CapacityPolicy capacity_policy_;
+    std::unique_ptr<SlotPool> pool_; // Null in fixed mode
+    std::array<std::unique_ptr<FairShare>, kLevels> fair_; // Null when off
+    std::array<std::unique_ptr<CoalesceIndex>, kLevels> coalesce_; // Null when off
+    size_t pool_slots_ = 0;
+    size_t budget_ = 0; // Sum of nominal level capacities
+    std::array<std::unique_ptr<BoundedQueue>, kLevels> queues_;
     std::atomic<size_t> total_items_{0};
+    std::atomic<uint64_t> evicted_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<bool> force_strict_{false};
+    bool has_ttl_ = false;
+
+    // DRR credit bookkeeping, shared by all consumers
+    SpinLock drr_lock_;
+    size_t drr_cursor_ = 0;
+    std::array<uint32_t, kLevels> deficit_{};
 };
 
 // ============================================================================
@@ -498,117 +1352,1354 @@ private:
 };
 
 // ============================================================================
-// SECTION 7: MAIN PROCESSING ENGINE
+// SECTION 7: ASYNC IO TIMER WHEEL
 // ============================================================================
+// Hashed timer wheel for IO waits. A worker parks the item here instead of
+// sleeping; when the wait elapses the wheel thread hands the item back via
+// the completion callback so a worker can finish it. Scheduling and firing
+// are O(1) per item; timers beyond one revolution carry a rounds counter.
 
-class TitanEngine {
+class TimerWheel {
 public:
-    struct Config {
-        size_t queue_capacity = 1024;
-        size_t num_workers = 4;
-        double circuit_failure_rate = 0.5; // 50% failure trips breaker
-    };
-
-    explicit TitanEngine(Config config)
-        : config_(config),
-          router_(config.queue_capacity),
-          circuit_breaker_(config.circuit_failure_rate, 2000), // 2s reset
-          running_(true) {
-        
-        LOG_INFO(std::format("Initializing TitanEngine with {} workers", config.num_workers));
-        start_workers();
+    using Callback = std::function<void(WorkItem&&)>;
+
+    // on_idle runs on the wheel thread each time the last in-flight timer
+    // has been handed back, for owners that wait on in_flight() reaching 0.
+    TimerWheel(Nanoseconds tick, size_t slots, size_t max_in_flight, Callback on_fire,
+               std::function<void()> on_idle = {})
+        : tick_ns_(static_cast<uint64_t>(tick.count())),
+          max_in_flight_(max_in_flight),
+          on_fire_(std::move(on_fire)),
+          on_idle_(std::move(on_idle)),
+          slots_(slots),
+          wheel_time_ns_(now_ns()) {
+        thread_ = std::jthread([this](std::stop_token st) { run(st); });
     }
 
-    ~TitanEngine() {
-        stop();
-    }
+    ~TimerWheel() { stop(); }
 
-    // The main entry point for producers
-    bool submit(WorkItem item) {
-        if (!running_.load()) return false;
+    // Parks the item until `delay` has elapsed. Returns false, leaving the
+    // item untouched, when the in-flight limit is reached.
+    bool schedule(WorkItem&& item, Nanoseconds delay) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (in_flight_.load(std::memory_order_relaxed) >= max_in_flight_) return false;
 
-        // 1. Check Circuit Breaker
-        if (!circuit_breaker_.allow_request()) {
-            metrics_.tasks_rejected_circuit_open.fetch_add(1);
-            return false; 
-        }
+            uint64_t now = now_ns();
+            // An empty wheel has no timers anchored to the cursor, so re-anchor
+            // it to the present instead of making the thread catch up.
+            if (in_flight_.load(std::memory_order_relaxed) == 0) wheel_time_ns_ = now;
 
-        // 2. Try Enqueue
-        bool accepted = router_.try_push(std::move(item));
-        
-        if (accepted) {
-            metrics_.tasks_submitted.fetch_add(1, std::memory_order_relaxed);
-            metrics_.current_queue_depth.store(router_.total_size(), std::memory_order_relaxed);
-            work_available_cv_.notify_one();
-        } else {
-            metrics_.tasks_rejected_queue_full.fetch_add(1, std::memory_order_relaxed);
-        }
+            uint64_t fire_at = now + static_cast<uint64_t>(delay.count());
+            uint64_t ticks = (fire_at - wheel_time_ns_ + tick_ns_ - 1) / tick_ns_;
+            if (ticks == 0) ticks = 1;
 
-        return accepted;
+            size_t slot = (cursor_ + ticks) % slots_.size();
+            slots_[slot].push_back({(ticks - 1) / slots_.size(), std::move(item)});
+            in_flight_.fetch_add(1, std::memory_order_release);
+        }
+        cv_.notify_one();
+        return true;
     }
 
+    size_t in_flight() const { return in_flight_.load(std::memory_order_acquire); }
+
     void stop() {
-        bool expected = true;
-        if (running_.compare_exchange_strong(expected, false)) {
-            LOG_INFO("Stopping TitanEngine...");
-            work_available_cv_.notify_all();
-            for (auto& t : workers_) {
-                if (t.joinable()) t.join();
-            }
-            LOG_INFO("TitanEngine Stopped.");
+        if (thread_.joinable()) {
+            thread_.request_stop();
+            cv_.notify_all();
+            thread_.join();
         }
     }
 
-    const SystemMetrics& get_metrics() const { return metrics_; }
-
 private:
-    void start_workers() {
-        workers_.reserve(config_.num_workers);
-        for (size_t i = 0; i < config_.num_workers; ++i) {
-            workers_.emplace_back(&TitanEngine::worker_loop, this, i);
-        }
-    }
+    struct Timer {
+        uint64_t rounds;
+        WorkItem item;
+    };
 
-    void worker_loop(size_t worker_id) {
-        LOG_INFO(std::format("Worker {} started", worker_id));
-        
-        while (running_.load() || router_.total_size() > 0) {
-            std::unique_lock<std::mutex> lock(cv_mutex_);
-            work_available_cv_.wait(lock, [this] {
-                return !running_.load() || router_.total_size() > 0;
-            });
+    void run(std::stop_token st) {
+        std::vector<WorkItem> expired;
+        while (!st.stop_requested()) {
+            uint64_t next_tick_ns;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                // Idle wheel: sleep until something is scheduled
+                cv_.wait(lock, st, [this] { return in_flight_.load() > 0; });
+                if (st.stop_requested()) break;
+                next_tick_ns = wheel_time_ns_ + tick_ns_;
+            }
 
-            if (!running_.load() && router_.total_size() == 0) break;
+            std::this_thread::sleep_until(Clock::time_point(Nanoseconds(next_tick_ns)));
 
-            // Unlock to allow other workers to wake up
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                // Catch up on every tick that elapsed while we slept
+                uint64_t now = now_ns();
+                while (wheel_time_ns_ + tick_ns_ <= now) {
+                    wheel_time_ns_ += tick_ns_;
+                    cursor_ = (cursor_ + 1) % slots_.size();
+                    collect(slots_[cursor_], expired);
+                }
+            }
+
+            for (auto& item : expired) {
+                on_fire_(std::move(item));
+                if (in_flight_.fetch_sub(1, std::memory_order_acq_rel) == 1 && on_idle_) on_idle_();
+            }
+            expired.clear();
+        }
+    }
+
+    // Moves due timers out of the slot; later revolutions lose one round.
+    static void collect(std::vector<Timer>& slot, std::vector<WorkItem>& out) {
+        size_t keep = 0;
+        for (size_t i = 0; i < slot.size(); ++i) {
+            if (slot[i].rounds == 0) {
+                out.push_back(std::move(slot[i].item));
+            } else {
+                slot[i].rounds--;
+                if (keep != i) slot[keep] = std::move(slot[i]);
+                keep++;
+            }
+        }
+        slot.resize(keep);
+    }
+
+    uint64_t tick_ns_;
+    size_t max_in_flight_;
+    Callback on_fire_;
+    std::function<void()> on_idle_;
+
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::vector<std::vector<Timer>> slots_;
+    size_t cursor_ = 0;
+    uint64_t wheel_time_ns_;
+    std::atomic<size_t> in_flight_{0};
+    std::jthread thread_;
+};
+
+// ============================================================================
+// SECTION 8: BACKPRESSURE-AWARE ADMISSION
+// ============================================================================
+// Instead of spinning on a rejected submit, a producer can park until its
+// priority level has room. Parked submissions wait in a FIFO per level and
+// are admitted strictly in order as workers free slots.
+
+enum class SubmitStatus {
+    PENDING,               // Parked, waiting for capacity
+    ACCEPTED,
+    TIMED_OUT,             // Deadline passed while parked
+    WOULD_EXCEED_DEADLINE, // Failed fast: expected wait is past the deadline
+    CIRCUIT_OPEN,
+    CANCELLED,             // Withdrawn by the producer
+    STOPPED                // Engine shut down first
+};
+
+// Completion token for one parked submission. Resolves exactly once; the
+// optional callback fires once, on whichever thread resolved it, outside
+// any engine lock.
+class SubmitTicket {
+public:
+    explicit SubmitTicket(std::function<void(SubmitStatus)> on_done = {})
+        : on_done_(std::move(on_done)) {}
+
+    SubmitStatus status() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return status_;
+    }
+
+    SubmitStatus wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return status_ != SubmitStatus::PENDING; });
+        return status_;
+    }
+
+    // Returns PENDING if still unresolved at `deadline`
+    SubmitStatus wait_until(Clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_until(lock, deadline, [this] { return status_ != SubmitStatus::PENDING; });
+        return status_;
+    }
+
+    // Withdraws the submission if it is still parked. Returns false if it
+    // had already been resolved; status() then says how.
+    bool cancel() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // An admission attempt in progress finishes first
+            cv_.wait(lock, [this] { return !claimed_; });
+            if (status_ != SubmitStatus::PENDING) return false;
+            status_ = SubmitStatus::CANCELLED;
+            cv_.notify_all();
+        }
+        notify_done();
+        return true;
+    }
+
+private:
+    friend class TitanEngine;
+
+    // Engine side: pins a pending ticket while its item is being pushed,
+    // so cancel() cannot race the admission.
+    bool try_claim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (status_ != SubmitStatus::PENDING || claimed_) return false;
+        claimed_ = true;
+        return true;
+    }
+
+    void release_claim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        claimed_ = false;
+        cv_.notify_all();
+    }
+
+    bool resolve(SubmitStatus status) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (status_ != SubmitStatus::PENDING) return false;
+        status_ = status;
+        claimed_ = false;
+        cv_.notify_all();
+        return true;
+    }
+
+    void notify_done() {
+        if (on_done_) on_done_(status());
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    SubmitStatus status_ = SubmitStatus::PENDING;
+    bool claimed_ = false;
+    std::function<void(SubmitStatus)> on_done_;
+};
+
+// ============================================================================
+// SECTION 9: CPU WORKLOAD KERNELS
+// ============================================================================
+// CPU_INTENSIVE items run one of four kernels shaped like real worker code
+// (buffer hashing, LZ block compression, a small GEMM, structural JSON
+// scanning) over per-thread input buffers, so benchmarks see realistic
+// cache and vector-unit pressure. Each kernel has a portable version and,
+// on x86-64, an AVX2 version picked once at startup from CPUID. Both
+// produce the same result (GEMM up to FMA rounding).
+
+enum class CpuKernel : uint8_t {
+    TRIG,     // Legacy sin*cos loop; mostly measures libm
+    HASH,
+    COMPRESS,
+    GEMM,
+    PARSE,
+    MIXED     // One of the four above per item, picked by item id
+};
+
+struct KernelSet {
+    const char* isa;
+    uint32_t (*hash)(const uint8_t* data, size_t len);
+    size_t (*compress)(const uint8_t* src, size_t len);           // Returns compressed size
+    float (*gemm)(const float* a, const float* b, float* c);      // Returns checksum of C
+    size_t (*scan)(const uint8_t* doc, size_t len);               // Returns structural count
+};
+
+constexpr size_t kGemmN = 32;
+constexpr uint32_t kHashPrime1 = 2654435761u;
+constexpr uint32_t kHashPrime2 = 2246822519u;
+constexpr uint32_t kHashPrime3 = 3266489917u;
+
+// --- Hash: 8 independent 32-bit lanes (xxHash32-style rounds) ---
+
+inline uint32_t rotl32(uint32_t x, int r) { return (x << r) | (x >> (32 - r)); }
+
+inline uint32_t hash_finish(const uint32_t (&lanes)[8], const uint8_t* tail, size_t tail_len, size_t len) {
+    uint32_t h = static_cast<uint32_t>(len) * kHashPrime3;
+    for (uint32_t lane : lanes) h = rotl32(h ^ lane, 7) * kHashPrime1;
+    for (size_t i = 0; i < tail_len; ++i) h = rotl32(h ^ tail[i], 11) * kHashPrime1;
+    h ^= h >> 15;
+    h *= kHashPrime2;
+    return h ^ (h >> 13);
+}
+
+inline void hash_seed(uint32_t (&lanes)[8]) {
+    for (uint32_t i = 0; i < 8; ++i) lanes[i] = kHashPrime1 + i * kHashPrime2;
+}
+
+uint32_t hash_block_scalar(const uint8_t* data, size_t len) {
+    uint32_t lanes[8];
+    hash_seed(lanes);
+    size_t blocks = len / 32;
+    for (size_t b = 0; b < blocks; ++b) {
+        for (size_t i = 0; i < 8; ++i) {
+            uint32_t word;
+            std::memcpy(&word, data + b * 32 + i * 4, 4);
+            lanes[i] = rotl32(lanes[i] + word * kHashPrime2, 13) * kHashPrime1;
+        }
+    }
+    return hash_finish(lanes, data + blocks * 32, len % 32, len);
+}
+
+// --- Compress: greedy LZ77 with a 4-byte hash table ---
+// Only the match-extension loop differs between ISAs.
+
+template <size_t (*MatchLength)(const uint8_t*, const uint8_t*, size_t)>
+size_t lz_compressed_size(const uint8_t* src, size_t len) {
+    constexpr size_t kTableBits = 12;
+    uint32_t table[size_t{1} << kTableBits] = {};
+    size_t out = 0, literals = 0, i = 0;
+    while (i + 4 <= len) {
+        uint32_t seq;
+        std::memcpy(&seq, src + i, 4);
+        uint32_t slot = (seq * kHashPrime1) >> (32 - kTableBits);
+        size_t candidate = table[slot];
+        table[slot] = static_cast<uint32_t>(i);
+        if (candidate < i && i - candidate <= 0xFFFF && std::memcmp(src + candidate, src + i, 4) == 0) {
+            size_t match = 4 + MatchLength(src + candidate + 4, src + i + 4, len - i - 4);
+            out += literals + 3; // Token + 16-bit offset
+            literals = 0;
+            i += match;
+        } else {
+            literals++;
+            i++;
+        }
+    }
+    return out + literals + (len - i);
+}
+
+inline size_t match_length_scalar(const uint8_t* a, const uint8_t* b, size_t max) {
+    size_t n = 0;
+    while (n < max && a[n] == b[n]) n++;
+    return n;
+}
+
+size_t compress_block_scalar(const uint8_t* src, size_t len) {
+    return lz_compressed_size<match_length_scalar>(src, len);
+}
+
+// --- GEMM: C = A * B, row-major kGemmN x kGemmN ---
+
+inline float gemm_checksum(const float* c) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < kGemmN * kGemmN; ++i) sum += c[i];
+    return sum;
+}
+
+float gemm_scalar(const float* a, const float* b, float* c) {
+    std::fill(c, c + kGemmN * kGemmN, 0.0f);
+    for (size_t i = 0; i < kGemmN; ++i) {
+        for (size_t k = 0; k < kGemmN; ++k) {
+            float aik = a[i * kGemmN + k];
+            for (size_t j = 0; j < kGemmN; ++j) c[i * kGemmN + j] += aik * b[k * kGemmN + j];
+        }
+    }
+    return gemm_checksum(c);
+}
+
+// --- Parse: count structural characters outside strings (no escapes) ---
+// Works on 32-byte chunks: classify into quote/structural bitmasks, turn
+// quote bits into an in-string mask with a prefix XOR, then popcount.
+
+inline size_t count_structurals(uint32_t quotes, uint32_t structurals, uint32_t& in_string) {
+    uint32_t mask = quotes;
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= in_string;
+    in_string = static_cast<uint32_t>(static_cast<int32_t>(mask) >> 31);
+    return std::popcount(structurals & ~mask);
+}
+
+inline bool is_structural(uint8_t ch) {
+    return ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ':' || ch == ',';
+}
+
+size_t scan_structurals_scalar(const uint8_t* doc, size_t len) {
+    size_t count = 0;
+    uint32_t in_string = 0;
+    for (size_t base = 0; base + 32 <= len; base += 32) {
+        uint32_t quotes = 0, structurals = 0;
+        for (uint32_t i = 0; i < 32; ++i) {
+            quotes |= uint32_t{doc[base + i] == '"'} << i;
+            structurals |= uint32_t{is_structural(doc[base + i])} << i;
+        }
+        count += count_structurals(quotes, structurals, in_string);
+    }
+    return count;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) uint32_t hash_block_avx2(const uint8_t* data, size_t len) {
+    alignas(32) uint32_t lanes[8];
+    hash_seed(lanes);
+    __m256i acc = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+    const __m256i p1 = _mm256_set1_epi32(static_cast<int>(kHashPrime1));
+    const __m256i p2 = _mm256_set1_epi32(static_cast<int>(kHashPrime2));
+    size_t blocks = len / 32;
+    for (size_t b = 0; b < blocks; ++b) {
+        __m256i word = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + b * 32));
+        acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(word, p2));
+        acc = _mm256_or_si256(_mm256_slli_epi32(acc, 13), _mm256_srli_epi32(acc, 19));
+        acc = _mm256_mullo_epi32(acc, p1);
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return hash_finish(lanes, data + blocks * 32, len % 32, len);
+}
+
+__attribute__((target("avx2"))) inline size_t match_length_avx2(const uint8_t* a, const uint8_t* b, size_t max) {
+    size_t n = 0;
+    while (n + 32 <= max) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + n));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + n));
+        uint32_t diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+        if (diff) return n + std::countr_zero(diff);
+        n += 32;
+    }
+    while (n < max && a[n] == b[n]) n++;
+    return n;
+}
+
+__attribute__((target("avx2"))) size_t compress_block_avx2(const uint8_t* src, size_t len) {
+    return lz_compressed_size<match_length_avx2>(src, len);
+}
+
+__attribute__((target("avx2,fma"))) float gemm_avx2(const float* a, const float* b, float* c) {
+    static_assert(kGemmN % 8 == 0);
+    for (size_t i = 0; i < kGemmN; ++i) {
+        __m256 row[kGemmN / 8];
+        for (auto& r : row) r = _mm256_setzero_ps();
+        for (size_t k = 0; k < kGemmN; ++k) {
+            __m256 aik = _mm256_broadcast_ss(a + i * kGemmN + k);
+            for (size_t j = 0; j < kGemmN / 8; ++j) {
+                row[j] = _mm256_fmadd_ps(aik, _mm256_loadu_ps(b + k * kGemmN + j * 8), row[j]);
+            }
+        }
+        for (size_t j = 0; j < kGemmN / 8; ++j) _mm256_storeu_ps(c + i * kGemmN + j * 8, row[j]);
+    }
+    return gemm_checksum(c);
+}
+
+__attribute__((target("avx2"))) inline __m256i eq_byte_avx2(__m256i chunk, char ch) {
+    return _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(ch));
+}
+
+__attribute__((target("avx2"))) size_t scan_structurals_avx2(const uint8_t* doc, size_t len) {
+    size_t count = 0;
+    uint32_t in_string = 0;
+    for (size_t base = 0; base + 32 <= len; base += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(doc + base));
+        __m256i brackets = _mm256_or_si256(_mm256_or_si256(eq_byte_avx2(chunk, '{'), eq_byte_avx2(chunk, '}')),
+                                           _mm256_or_si256(eq_byte_avx2(chunk, '['), eq_byte_avx2(chunk, ']')));
+        __m256i separators = _mm256_or_si256(eq_byte_avx2(chunk, ':'), eq_byte_avx2(chunk, ','));
+        uint32_t quotes = static_cast<uint32_t>(_mm256_movemask_epi8(eq_byte_avx2(chunk, '"')));
+        uint32_t structurals = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(brackets, separators)));
+        count += count_structurals(quotes, structurals, in_string);
+    }
+    return count;
+}
+#endif
+
+inline const KernelSet& scalar_kernels() {
+    static const KernelSet set{"scalar", hash_block_scalar, compress_block_scalar, gemm_scalar,
+                               scan_structurals_scalar};
+    return set;
+}
+
+// Best kernels for this CPU, resolved once
+inline const KernelSet& native_kernels() {
+    static const KernelSet set = [] {
+#if defined(__x86_64__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return KernelSet{"avx2", hash_block_avx2, compress_block_avx2, gemm_avx2, scan_structurals_avx2};
+        }
+#endif
+        return scalar_kernels();
+    }();
+    return set;
+}
+
+// Per-thread inputs, generated once with a fixed seed so every worker
+// (and every run) processes the same bytes.
+struct KernelInputs {
+    static constexpr size_t kBufferBytes = 64 * 1024;
+
+    std::vector<uint8_t> random;  // Hash input
+    std::vector<uint8_t> text;    // Compressible: words from a small vocabulary
+    std::vector<uint8_t> json;    // Flat records with strings, numbers, arrays
+    std::vector<float> a, b, c;
+
+    KernelInputs() : random(kBufferBytes), a(kGemmN * kGemmN), b(kGemmN * kGemmN), c(kGemmN * kGemmN) {
+        std::mt19937 rng(0x71747A);
+        for (auto& byte : random) byte = static_cast<uint8_t>(rng());
+
+        static constexpr std::string_view kWords[] = {"order ", "status ", "queue ", "worker ", "latency ",
+                                                      "priority ", "timeout ", "retry ", "shard ", "ack "};
+        text.reserve(kBufferBytes + 16);
+        while (text.size() < kBufferBytes) {
+            auto word = kWords[rng() % std::size(kWords)];
+            text.insert(text.end(), word.begin(), word.end());
+        }
+        text.resize(kBufferBytes);
+
+        json.reserve(kBufferBytes + 128);
+        json.push_back('[');
+        for (uint32_t rec = 0; json.size() < kBufferBytes - 128; ++rec) {
+            std::string record = std::format("{{\"id\":{},\"name\":\"user, {}\",\"tags\":[\"a:{}\",\"b\"],\"score\":{}}},",
+                                             rec, rng() % 1000, rng() % 10, rng() % 100000);
+            json.insert(json.end(), record.begin(), record.end());
+        }
+        json.back() = ']';
+        json.resize(kBufferBytes, ' ');
+
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (auto& v : a) v = dist(rng);
+        for (auto& v : b) v = dist(rng);
+    }
+
+    static KernelInputs& local() {
+        thread_local KernelInputs inputs;
+        return inputs;
+    }
+};
+
+// Runs `kernel` with work proportional to `difficulty` (complexity_score,
+// 0-1000): byte kernels process difficulty KiB, GEMM does difficulty/8
+// multiplies. Returns a value derived from every result so nothing is
+// optimized out.
+inline uint64_t run_cpu_kernel(const KernelSet& ks, CpuKernel kernel, uint32_t difficulty, uint64_t item_id) {
+    if (kernel == CpuKernel::MIXED) {
+        kernel = static_cast<CpuKernel>(static_cast<uint8_t>(CpuKernel::HASH) + item_id % 4);
+    }
+
+    auto& in = KernelInputs::local();
+    auto over_bytes = [&](const std::vector<uint8_t>& buf, auto&& fn) {
+        uint64_t acc = 0;
+        size_t remaining = size_t{difficulty} * 1024;
+        while (remaining > 0) {
+            size_t n = std::min(remaining, buf.size());
+            acc += fn(buf.data(), n);
+            remaining -= n;
+        }
+        return acc;
+    };
+
+    switch (kernel) {
+        case CpuKernel::HASH: return over_bytes(in.random, ks.hash);
+        case CpuKernel::COMPRESS: return over_bytes(in.text, ks.compress);
+        case CpuKernel::PARSE: return over_bytes(in.json, ks.scan);
+        case CpuKernel::GEMM: {
+            float acc = 0.0f;
+            for (uint32_t r = 0; r < difficulty / 8 + 1; ++r) acc += ks.gemm(in.a.data(), in.b.data(), in.c.data());
+            return static_cast<uint64_t>(std::fabs(acc));
+        }
+        case CpuKernel::TRIG:
+        case CpuKernel::MIXED:
+            break;
+    }
+
+    double result = 0;
+    for (uint32_t i = 0; i < difficulty * 100; ++i) result += std::sin(i) * std::cos(i);
+    return static_cast<uint64_t>(std::fabs(result));
+}
+
+// ============================================================================
+// SECTION 10: MAIN PROCESSING ENGINE
+// ============================================================================
+
+class TitanEngine {
+public:
+    // Periodic view of a shutdown drain in progress
+    struct DrainProgress {
+        Milliseconds elapsed{0};
+        std::array<size_t, PriorityRouter::kLevels> queued{}; // Per level
+        size_t io_in_flight = 0;
+        uint64_t finished = 0; // Executed since stop() began
+        uint64_t shed = 0;
+        bool shedding = false; // Deadline passed
+    };
+
+    // What stop() did with the work it found
+    struct DrainReport {
+        Milliseconds elapsed{0};
+        bool deadline_hit = false;
+        uint64_t finished = 0;
+        std::array<size_t, PriorityRouter::kLevels> shed{}; // Per level
+    };
+
+    struct Config {
+        size_t queue_capacity = 1024;
+        size_t num_workers = 4;
+        double circuit_failure_rate = 0.5; // 50% failure trips breaker
+        PriorityRouter::Policy dequeue_policy{};
+        PriorityRouter::CapacityPolicy capacity_policy{};
+        // IO_BOUND items wait on the timer wheel instead of a worker thread.
+        // Beyond max_io_in_flight parked items, workers fall back to sleeping.
+        bool async_io = true;
+        size_t max_io_in_flight = 8192;
+        Microseconds io_tick{100};
+        // Items a worker takes from the router per wakeup
+        size_t pop_batch = 1;
+        // Parked submits fail fast when the expected wait (queue position x
+        // recent admission interval) already lands past their deadline
+        bool admission_fail_fast = true;
+        // What CPU_INTENSIVE items execute; cpu_simd=false pins the
+        // portable kernels (for A/B runs against the native ones)
+        CpuKernel cpu_kernel = CpuKernel::MIXED;
+        bool cpu_simd = true;
+
+        // Elastic pool. When enabled, num_workers is the starting size and
+        // the controller moves it within [min_workers, max_workers].
+        struct Autoscale {
+            bool enabled = false;
+            size_t min_workers = 1;
+            size_t max_workers = 64;
+            Milliseconds interval{100};
+            // Grow signals: backlog per worker, or windowed mean latency
+            double depth_per_worker = 8.0;
+            uint64_t target_latency_us = 20'000;
+            // Past hardware_concurrency, only grow if workers mostly block
+            double blocked_fraction_to_oversubscribe = 0.5;
+            // Shrink signal: busy fraction of the pool with no backlog
+            double low_utilization = 0.3;
+            // Hysteresis: consecutive intervals a signal must hold
+            uint32_t grow_after = 2;
+            uint32_t shrink_after = 5;
+        } autoscale;
+
+        // Shutdown drain. Queued work is served in strict priority order;
+        // once `deadline` passes, levels below keep_through are shed in
+        // bulk while the urgent ones still run to completion. A zero
+        // deadline drains everything, however long that takes.
+        struct Drain {
+            Milliseconds deadline{0};
+            Priority keep_through = Priority::HIGH;
+            Milliseconds progress_interval{250};
+            std::function<void(const DrainProgress&)> on_progress; // Default: log
+        } drain;
+    };
+
+    explicit TitanEngine(Config config)
+        : config_(normalize(config)),
+          router_(config.queue_capacity, config.dequeue_policy, config.capacity_policy),
+          circuit_breaker_(config.circuit_failure_rate, 2000), // 2s reset
+          running_(true),
+          io_wheel_(config.io_tick, 1024, config.max_io_in_flight,
+                    [this](WorkItem&& item) { on_io_complete(std::move(item)); },
+                    [this] { on_io_idle(); }) {
+        
+        LOG_INFO(std::format("Initializing TitanEngine with {} workers", config_.num_workers));
+        start_workers();
+        expiry_thread_ = std::jthread([this](std::stop_token st) { expiry_loop(st); });
+    }
+
+    ~TitanEngine() {
+        stop();
+    }
+
+    // The main entry point for producers
+    bool submit(WorkItem item) {
+        if (!running_.load()) return false;
+
+        // 1. Check Circuit Breaker
+        if (!circuit_breaker_.allow_request()) {
+            metrics_.tasks_rejected_circuit_open.add(1);
+            return false; 
+        }
+
+        // 2. Try Enqueue, unless parked submits still hold the level
+        bool merged = false;
+        bool accepted = line_clear(static_cast<size_t>(item.priority)) && router_.try_push(std::move(item), &merged);
+        
+        if (accepted) {
+            metrics_.tasks_submitted.add(1);
+            // A merged duplicate adds no work, so nobody needs waking
+            if (!merged) work_available_cv_.notify_one();
+        } else {
+            metrics_.tasks_rejected_queue_full.add(1);
+        }
+
+        return accepted;
+    }
+
+    // Batched entry point: one breaker check, one router pass and one
+    // wakeup for the whole batch. Items are taken in order; returns how many
+    // were accepted. The rest are left in place for the caller to retry.
+    // Like submit, the batch stops at the first item whose level still has
+    // parked submits after a drain.
+    size_t submit_batch(std::span<WorkItem> items) {
+        if (items.empty() || !running_.load()) return 0;
+
+        if (!circuit_breaker_.allow_request()) {
+            metrics_.tasks_rejected_circuit_open.add(items.size());
+            return 0;
+        }
+
+        size_t accepted = push_batch(items);
+        if (accepted < items.size()) {
+            metrics_.tasks_rejected_queue_full.add(items.size() - accepted);
+        }
+
+        return accepted;
+    }
+
+    // submit_batch for a caller that keeps the refused suffix and offers it
+    // again until it is taken: a refusal is not counted as a rejection, or
+    // every retry would count the same items again.
+    size_t offer_batch(std::span<WorkItem> items) {
+        if (items.empty() || !running_.load() || !circuit_breaker_.allow_request()) return 0;
+        return push_batch(items);
+    }
+
+    // Completion-token submit. Tries to enqueue at once; if the level is
+    // full (or others are already parked there) the item parks in FIFO
+    // order until a worker frees room, the deadline passes, or the producer
+    // cancels the ticket. An expiry thread resolves a parked ticket
+    // TIMED_OUT once its deadline passes, wherever it sits in the line, so
+    // on_done fires even while the head of the line cannot be admitted.
+    std::shared_ptr<SubmitTicket> submit_async(WorkItem item, Clock::time_point deadline,
+                                               std::function<void(SubmitStatus)> on_done = {}) {
+        auto ticket = std::make_shared<SubmitTicket>(std::move(on_done));
+        auto resolved = [&ticket](SubmitStatus status) {
+            ticket->resolve(status);
+            ticket->notify_done();
+            return ticket;
+        };
+
+        if (!running_.load()) return resolved(SubmitStatus::STOPPED);
+        if (!circuit_breaker_.allow_request()) {
+            metrics_.tasks_rejected_circuit_open.add();
+            return resolved(SubmitStatus::CIRCUIT_OPEN);
+        }
+
+        size_t lvl = static_cast<size_t>(item.priority);
+        auto& line = wait_lines_[lvl];
+
+        // Fast path only when nobody is parked here, so we do not jump the line
+        if (line.parked.load(std::memory_order_acquire) == 0 && router_.try_push(std::move(item))) {
+            metrics_.tasks_submitted.add();
+            work_available_cv_.notify_one();
+            return resolved(SubmitStatus::ACCEPTED);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(line.mutex);
+            // stop() clears running_ before it empties the lines under this mutex, so a
+            // submit that gets here after that sees it and does not park forever
+            if (!running_.load()) return resolved(SubmitStatus::STOPPED);
+            uint64_t now = now_ns();
+            uint64_t deadline_ns = static_cast<uint64_t>(
+                std::chrono::duration_cast<Nanoseconds>(deadline.time_since_epoch()).count());
+            if (now >= deadline_ns) {
+                metrics_.admission_timed_out.add();
+                return resolved(SubmitStatus::TIMED_OUT);
+            }
+            if (config_.admission_fail_fast && line.admit_interval_ns > 0) {
+                double expected_ns = (line.waiters.size() + 1) * line.admit_interval_ns;
+                if (now + static_cast<uint64_t>(expected_ns) > deadline_ns) {
+                    metrics_.admission_failed_fast.add();
+                    return resolved(SubmitStatus::WOULD_EXCEED_DEADLINE);
+                }
+            }
+
+            line.waiters.push_back({std::move(item), deadline, ticket});
+            line.parked.fetch_add(1, std::memory_order_release);
+            waiting_.fetch_add(1, std::memory_order_release);
+        }
+        note_parked_deadline(deadline);
+
+        // Room may have opened between the failed push and parking
+        drain_wait_line(lvl);
+        return ticket;
+    }
+
+    // Blocking submit with a deadline: parks the calling thread until the
+    // item is admitted or the deadline passes.
+    SubmitStatus submit_until(WorkItem item, Clock::time_point deadline) {
+        auto ticket = submit_async(std::move(item), deadline);
+        SubmitStatus status = ticket->wait_until(deadline);
+        if (status != SubmitStatus::PENDING) return status;
+
+        if (ticket->cancel()) {
+            metrics_.admission_timed_out.add();
+            return SubmitStatus::TIMED_OUT;
+        }
+        return ticket->status();
+    }
+
+    // Stops intake and drains queued work under config_.drain. Only the
+    // first call does anything; later calls return an empty report.
+    DrainReport stop() {
+        DrainReport report;
+        bool expected = true;
+        if (running_.compare_exchange_strong(expected, false)) {
+            LOG_INFO("Stopping TitanEngine...");
+            release_wait_lines(SubmitStatus::STOPPED);
+            if (expiry_thread_.joinable()) {
+                expiry_thread_.request_stop();
+                expiry_thread_.join();
+            }
+            // Freeze the pool size before draining
+            if (scaler_thread_.joinable()) {
+                scaler_thread_.request_stop();
+                scaler_thread_.join();
+            }
+            router_.force_strict(true);
+            work_available_cv_.notify_all();
+            drain(report);
+            for (auto& slot : worker_slots_) {
+                if (slot->thread.joinable()) slot->thread.join();
+            }
+            io_wheel_.stop();
+            LOG_INFO(std::format("TitanEngine Stopped. Drain took {} ms, {} finished, {} shed.",
+                                 report.elapsed.count(), report.finished,
+                                 std::accumulate(report.shed.begin(), report.shed.end(), size_t{0})));
+        }
+        return report;
+    }
+
+    const SystemMetrics& get_metrics() const { return metrics_; }
+
+    // Roughly how many more items submit() would accept right now
+    size_t admission_headroom() const {
+        if (!running_.load()) return 0;
+        return router_.headroom();
+    }
+
+    // Room at one level for a direct submit: none while submits are parked
+    // there, since they go first
+    size_t admission_headroom(Priority p) const {
+        if (!running_.load() || wait_lines_[static_cast<size_t>(p)].parked.load(std::memory_order_acquire) > 0) return 0;
+        return router_.headroom(p);
+    }
+
+    MetricsSnapshot snapshot() const {
+        MetricsSnapshot snap;
+        snap.taken_at_ns = now_ns();
+        snap.tasks_processed = metrics_.tasks_processed.load();
+        snap.tasks_failed = metrics_.tasks_failed.load();
+        snap.tasks_expired = metrics_.tasks_expired.load();
+        snap.tasks_evicted = router_.evicted();
+        snap.tasks_coalesced = router_.coalesced();
+        snap.tasks_shed = metrics_.tasks_shed.load();
+        snap.io_dispatched_async = metrics_.io_dispatched_async.load();
+        snap.io_blocking_fallback = metrics_.io_blocking_fallback.load();
+        snap.admitted_after_wait = metrics_.admitted_after_wait.load();
+        snap.admission_timed_out = metrics_.admission_timed_out.load();
+        snap.admission_failed_fast = metrics_.admission_failed_fast.load();
+        snap.tasks_submitted = metrics_.tasks_submitted.load();
+        snap.tasks_rejected_queue_full = metrics_.tasks_rejected_queue_full.load();
+        snap.tasks_rejected_circuit_open = metrics_.tasks_rejected_circuit_open.load();
+        snap.tasks_rejected_fairness = router_.fairness_rejects();
+        snap.queue_depth = router_.total_size();
+        snap.borrowed_slots = router_.borrowed_slots();
+        snap.active_workers = active_workers_.load();
+        return snap;
+    }
+
+private:
+    // Per-worker time accounting, written only by the owning worker
+    struct WorkerSlot {
+        std::jthread thread;
+        std::atomic<bool> live{false};
+        std::atomic<uint64_t> busy_ns{0};    // executing items, blocked or not
+        std::atomic<uint64_t> blocked_ns{0}; // of which sleeping in blocking IO
+    };
+
+    static Config normalize(Config config) {
+        auto& as = config.autoscale;
+        if (as.enabled) {
+            as.min_workers = std::max<size_t>(as.min_workers, 1);
+            as.max_workers = std::max(as.max_workers, as.min_workers);
+            config.num_workers = std::clamp(config.num_workers, as.min_workers, as.max_workers);
+        } else {
+            as.min_workers = as.max_workers = config.num_workers;
+        }
+        return config;
+    }
+
+    void start_workers() {
+        worker_slots_.reserve(config_.autoscale.max_workers);
+        for (size_t i = 0; i < config_.autoscale.max_workers; ++i) {
+            worker_slots_.push_back(std::make_unique<WorkerSlot>());
+        }
+
+        target_workers_.store(config_.num_workers);
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            for (size_t i = 0; i < config_.num_workers; ++i) spawn_worker_locked();
+        }
+
+        if (config_.autoscale.enabled) {
+            scaler_thread_ = std::jthread([this](std::stop_token st) { autoscale_loop(st); });
+        }
+    }
+
+    // Starts a worker in the first free slot. Caller holds pool_mutex_.
+    bool spawn_worker_locked() {
+        for (size_t i = 0; i < worker_slots_.size(); ++i) {
+            auto& slot = *worker_slots_[i];
+            if (slot.live.load(std::memory_order_acquire)) continue;
+            // Reap the retired thread that last used this slot
+            if (slot.thread.joinable()) slot.thread.join();
+            slot.live.store(true, std::memory_order_release);
+            active_workers_.fetch_add(1);
+            metrics_.active_workers.store(active_workers_.load(), std::memory_order_relaxed);
+            slot.thread = std::jthread(&TitanEngine::worker_loop, this, i);
+            return true;
+        }
+        return false;
+    }
+
+    bool should_retire() const {
+        return running_.load() && active_workers_.load() > target_workers_.load();
+    }
+
+    // Claims one retirement when the pool is above target. Only one of the
+    // racing workers wins each excess slot.
+    bool try_retire(size_t worker_id) {
+        size_t active = active_workers_.load();
+        while (running_.load() && active > target_workers_.load()) {
+            if (active_workers_.compare_exchange_weak(active, active - 1)) {
+                metrics_.active_workers.store(active - 1, std::memory_order_relaxed);
+                worker_slots_[worker_id]->live.store(false, std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // --- Pool Controller ---
+    // Samples the pool every interval. Grows on backlog or latency over
+    // target (past core count only if workers mostly block); shrinks when
+    // there is no backlog and the pool is mostly idle. A signal must hold
+    // for grow_after / shrink_after consecutive intervals, and the streaks
+    // reset after every resize so one burst cannot cause a flap.
+    void autoscale_loop(std::stop_token st) {
+        const auto& as = config_.autoscale;
+        const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+        uint64_t last_busy = 0, last_blocked = 0;
+        uint64_t last_lat_count = 0, last_lat_sum = 0;
+        uint64_t last_sample = now_ns();
+        uint32_t grow_streak = 0, shrink_streak = 0;
+
+        std::mutex sleep_mutex;
+        std::condition_variable_any sleep_cv;
+        while (!st.stop_requested()) {
+            {
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                sleep_cv.wait_for(lock, st, as.interval, [] { return false; });
+            }
+            if (st.stop_requested()) break;
+
+            uint64_t busy = 0, blocked = 0;
+            for (const auto& slot : worker_slots_) {
+                busy += slot->busy_ns.load(std::memory_order_relaxed);
+                blocked += slot->blocked_ns.load(std::memory_order_relaxed);
+            }
+            uint64_t lat_count = metrics_.processing_latency_us.get_count();
+            uint64_t lat_sum = metrics_.processing_latency_us.get_sum();
+            uint64_t now = now_ns();
+
+            size_t active = active_workers_.load();
+            double window_ns = static_cast<double>(now - last_sample) * active;
+            double d_busy = static_cast<double>(busy - last_busy);
+            double d_blocked = static_cast<double>(blocked - last_blocked);
+            double utilization = window_ns > 0 ? d_busy / window_ns : 0.0;
+            double blocked_frac = d_busy > 0 ? d_blocked / d_busy : 0.0;
+            uint64_t d_count = lat_count - last_lat_count;
+            uint64_t mean_latency_us = d_count ? (lat_sum - last_lat_sum) / d_count : 0;
+            size_t depth = router_.total_size();
+
+            last_busy = busy; last_blocked = blocked;
+            last_lat_count = lat_count; last_lat_sum = lat_sum;
+            last_sample = now;
+
+            bool pressured = depth > as.depth_per_worker * active ||
+                             mean_latency_us > as.target_latency_us;
+            bool can_grow = active < as.max_workers &&
+                            (active < cores || blocked_frac >= as.blocked_fraction_to_oversubscribe);
+            bool idle = depth == 0 && utilization < as.low_utilization &&
+                        mean_latency_us <= as.target_latency_us / 2;
+
+            grow_streak = (pressured && can_grow) ? grow_streak + 1 : 0;
+            shrink_streak = (idle && active > as.min_workers) ? shrink_streak + 1 : 0;
+
+            if (grow_streak >= as.grow_after) {
+                // Grow by a quarter of the pool so deep backlogs converge fast
+                size_t step = std::max<size_t>(1, active / 4);
+                size_t target = std::min(as.max_workers, active + step);
+                {
+                    std::lock_guard<std::mutex> lock(pool_mutex_);
+                    target_workers_.store(target);
+                    while (active_workers_.load() < target && spawn_worker_locked()) {}
+                }
+                metrics_.pool_grow_events.fetch_add(1, std::memory_order_relaxed);
+                LOG_INFO(std::format("Autoscale: grow {} -> {} (depth {}, lat {}us, blocked {:.2f})",
+                                     active, target, depth, mean_latency_us, blocked_frac));
+                grow_streak = shrink_streak = 0;
+            } else if (shrink_streak >= as.shrink_after) {
+                // Shrink one at a time; idle workers retire on their next wakeup
+                target_workers_.store(active - 1);
+                {
+                    std::lock_guard<std::mutex> lock(cv_mutex_);
+                    work_available_cv_.notify_all();
+                }
+                metrics_.pool_shrink_events.fetch_add(1, std::memory_order_relaxed);
+                LOG_INFO(std::format("Autoscale: shrink {} -> {} (util {:.2f})",
+                                     active, active - 1, utilization));
+                grow_streak = shrink_streak = 0;
+            }
+        }
+    }
+
+    // --- Parked Submissions ---
+    struct PendingSubmit {
+        WorkItem item;
+        Clock::time_point deadline;
+        std::shared_ptr<SubmitTicket> ticket;
+    };
+
+    struct WaitLine {
+        std::mutex mutex;
+        std::deque<PendingSubmit> waiters; // Cancelled tickets linger until drained
+        std::atomic<size_t> parked{0};
+        uint64_t last_admit_ns = 0;
+        double admit_interval_ns = 0.0;    // EWMA between admissions
+    };
+
+    // Admits parked items from the head of the line until one does not
+    // fit. The head keeps its place on failure, so admission stays FIFO.
+    void drain_wait_line(size_t lvl) {
+        auto& line = wait_lines_[lvl];
+        std::vector<std::shared_ptr<SubmitTicket>> done;
+        size_t admitted = 0;
+        {
+            std::lock_guard<std::mutex> lock(line.mutex);
+            auto now = Clock::now();
+            while (!line.waiters.empty()) {
+                auto& head = line.waiters.front();
+                if (head.ticket->try_claim()) {
+                    if (now >= head.deadline) {
+                        head.ticket->resolve(SubmitStatus::TIMED_OUT);
+                        metrics_.admission_timed_out.add();
+                    } else if (router_.try_push(std::move(head.item))) {
+                        head.ticket->resolve(SubmitStatus::ACCEPTED);
+                        metrics_.tasks_submitted.add();
+                        metrics_.admitted_after_wait.add();
+                        note_admission(line);
+                        admitted++;
+                    } else {
+                        head.ticket->release_claim();
+                        break;
+                    }
+                    done.push_back(std::move(head.ticket));
+                }
+                line.waiters.pop_front();
+                line.parked.fetch_sub(1, std::memory_order_release);
+                waiting_.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        if (admitted == 1) work_available_cv_.notify_one();
+        else if (admitted > 1) work_available_cv_.notify_all();
+        for (auto& ticket : done) ticket->notify_done();
+    }
+
+    // Pushes the prefix of `items` whose levels have no parked submits,
+    // counting what was taken and waking workers for it
+    size_t push_batch(std::span<WorkItem> items) {
+        std::array<bool, PriorityRouter::kLevels> checked{}, clear{};
+        size_t open = 0;
+        for (; open < items.size(); ++open) {
+            size_t lvl = static_cast<size_t>(items[open].priority);
+            if (!checked[lvl]) {
+                checked[lvl] = true;
+                clear[lvl] = line_clear(lvl);
+            }
+            if (!clear[lvl]) break;
+        }
+
+        size_t merged = 0;
+        size_t accepted = router_.try_push_batch(items.first(open), &merged);
+        if (accepted > 0) {
+            metrics_.tasks_submitted.add(accepted);
+            size_t queued = accepted - merged;
+            if (queued == 1) work_available_cv_.notify_one();
+            else if (queued > 1) work_available_cv_.notify_all();
+        }
+        return accepted;
+    }
+
+    // True when nobody is parked at `lvl`, draining the line first if needed.
+    // Direct submits check this so they do not jump ahead of parked ones.
+    bool line_clear(size_t lvl) {
+        if (wait_lines_[lvl].parked.load(std::memory_order_acquire) == 0) return true;
+        drain_wait_line(lvl);
+        return wait_lines_[lvl].parked.load(std::memory_order_acquire) == 0;
+    }
+
+    void drain_all_wait_lines() {
+        for (size_t lvl = 0; lvl < PriorityRouter::kLevels; ++lvl) {
+            if (wait_lines_[lvl].parked.load(std::memory_order_acquire) > 0) drain_wait_line(lvl);
+        }
+    }
+
+    // Resolves everything still parked, e.g. with STOPPED at shutdown
+    void release_wait_lines(SubmitStatus status) {
+        std::vector<std::shared_ptr<SubmitTicket>> done;
+        for (auto& line : wait_lines_) {
+            std::lock_guard<std::mutex> lock(line.mutex);
+            for (auto& pending : line.waiters) {
+                if (pending.ticket->try_claim() && pending.ticket->resolve(status)) {
+                    done.push_back(std::move(pending.ticket));
+                }
+            }
+            waiting_.fetch_sub(line.waiters.size(), std::memory_order_release);
+            line.parked.store(0, std::memory_order_release);
+            line.waiters.clear();
+        }
+        for (auto& ticket : done) ticket->notify_done();
+    }
+
+    // Wakes the expiry thread early if `deadline` comes before its next sweep
+    void note_parked_deadline(Clock::time_point deadline) {
+        std::lock_guard<std::mutex> lock(expiry_mutex_);
+        if (deadline < next_expiry_) {
+            next_expiry_ = deadline;
+            expiry_cv_.notify_one();
+        }
+    }
+
+    // Sleeps until the earliest parked deadline, then sweeps every line
+    void expiry_loop(std::stop_token st) {
+        std::unique_lock<std::mutex> lock(expiry_mutex_);
+        while (!st.stop_requested()) {
+            auto due = next_expiry_;
+            if (due == Clock::time_point::max()) {
+                expiry_cv_.wait(lock, st, [this] { return next_expiry_ != Clock::time_point::max(); });
+                continue;
+            }
+            if (Clock::now() < due) {
+                expiry_cv_.wait_until(lock, st, due, [this, due] { return next_expiry_ < due; });
+                continue;
+            }
+
+            next_expiry_ = Clock::time_point::max();
+            lock.unlock();
+            auto next = expire_wait_lines();
+            lock.lock();
+            next_expiry_ = std::min(next_expiry_, next);
+        }
+    }
+
+    // Resolves parked submits whose deadline has passed and drops cancelled
+    // ones, keeping the rest in FIFO order. Returns the earliest deadline
+    // still parked.
+    Clock::time_point expire_wait_lines() {
+        std::vector<std::shared_ptr<SubmitTicket>> done;
+        auto next = Clock::time_point::max();
+        auto now = Clock::now();
+        for (auto& line : wait_lines_) {
+            if (line.parked.load(std::memory_order_acquire) == 0) continue;
+
+            std::lock_guard<std::mutex> lock(line.mutex);
+            auto keep_end = std::remove_if(line.waiters.begin(), line.waiters.end(), [&](PendingSubmit& p) {
+                if (now < p.deadline) {
+                    if (p.ticket->status() != SubmitStatus::PENDING) return true;
+                    next = std::min(next, p.deadline);
+                    return false;
+                }
+                // Line mutex held: no admission can have this ticket claimed
+                if (p.ticket->try_claim()) {
+                    p.ticket->resolve(SubmitStatus::TIMED_OUT);
+                    metrics_.admission_timed_out.add();
+                    done.push_back(std::move(p.ticket));
+                }
+                return true;
+            });
+            size_t removed = static_cast<size_t>(line.waiters.end() - keep_end);
+            line.waiters.erase(keep_end, line.waiters.end());
+            line.parked.fetch_sub(removed, std::memory_order_release);
+            waiting_.fetch_sub(removed, std::memory_order_release);
+        }
+        for (auto& ticket : done) ticket->notify_done();
+        return next;
+    }
+
+    // Caller holds line.mutex
+    static void note_admission(WaitLine& line) {
+        uint64_t now = now_ns();
+        if (line.last_admit_ns != 0) {
+            double interval = static_cast<double>(now - line.last_admit_ns);
+            line.admit_interval_ns = line.admit_interval_ns == 0.0
+                                         ? interval
+                                         : 0.8 * line.admit_interval_ns + 0.2 * interval;
+        }
+        line.last_admit_ns = now;
+    }
+
+    // --- Shutdown Drain ---
+    // Runs on the stopping thread while workers empty the router. Wakes
+    // for progress reports, the deadline, and the last item going out.
+    void drain(DrainReport& report) {
+        const auto& policy = config_.drain;
+        const auto start = Clock::now();
+        const auto interval = std::max(policy.progress_interval, Milliseconds(1));
+        const uint64_t done_at_start = metrics_.tasks_processed.load() + metrics_.tasks_failed.load();
+        auto next_progress = start + interval;
+        uint64_t shed = 0;
+
+        auto progress = [&] {
+            DrainProgress p;
+            p.elapsed = std::chrono::duration_cast<Milliseconds>(Clock::now() - start);
+            for (size_t lvl = 0; lvl < PriorityRouter::kLevels; ++lvl) {
+                p.queued[lvl] = router_.size_at_priority(static_cast<Priority>(lvl));
+            }
+            p.io_in_flight = io_wheel_.in_flight();
+            p.finished = metrics_.tasks_processed.load() + metrics_.tasks_failed.load() - done_at_start;
+            p.shed = shed;
+            p.shedding = report.deadline_hit;
+            return p;
+        };
+
+        std::unique_lock<std::mutex> lock(cv_mutex_);
+        while (has_outstanding()) {
+            auto wake = next_progress;
+            if (policy.deadline.count() > 0 && !report.deadline_hit) {
+                wake = std::min(wake, start + policy.deadline);
+            }
+            drain_cv_.wait_until(lock, wake, [this] { return !has_outstanding(); });
+            lock.unlock();
+
+            auto now = Clock::now();
+            if (policy.deadline.count() > 0 && !report.deadline_hit && now >= start + policy.deadline) {
+                report.deadline_hit = true;
+                for (size_t lvl = static_cast<size_t>(policy.keep_through) + 1; lvl < PriorityRouter::kLevels; ++lvl) {
+                    report.shed[lvl] = router_.shed(static_cast<Priority>(lvl));
+                    shed += report.shed[lvl];
+                }
+                metrics_.tasks_shed.add(shed);
+                {
+                    // Idle workers re-check their exit condition
+                    std::lock_guard<std::mutex> guard(cv_mutex_);
+                    work_available_cv_.notify_all();
+                }
+                LOG_WARN(std::format("Drain deadline of {} ms passed, shed {} queued items", policy.deadline.count(), shed));
+            }
+            if (now >= next_progress) {
+                DrainProgress p = progress();
+                if (policy.on_progress) {
+                    policy.on_progress(p);
+                } else {
+                    LOG_INFO(std::format("Draining {} ms: queued C/H/N/L {}/{}/{}/{}, io {}, finished {}, shed {}",
+                                         p.elapsed.count(), p.queued[0], p.queued[1], p.queued[2], p.queued[3],
+                                         p.io_in_flight, p.finished, p.shed));
+                }
+                next_progress += interval;
+            }
+            lock.lock();
+        }
+
+        DrainProgress last = progress();
+        report.elapsed = last.elapsed;
+        report.finished = last.finished;
+    }
+
+    // Work a worker can pick up right now
+    bool has_work() const {
+        return router_.total_size() > 0 ||
+               completions_pending_.load(std::memory_order_acquire) > 0;
+    }
+
+    // Work that still has to pass through a worker before shutdown completes.
+    // The wheel is read first: it publishes a completion before dropping its
+    // in-flight count, so an item is never invisible to both checks.
+    bool has_outstanding() const {
+        return io_wheel_.in_flight() > 0 || has_work();
+    }
+
+    void worker_loop(size_t worker_id) {
+        LOG_INFO(std::format("Worker {} started", worker_id));
+
+        const size_t pop_batch = std::max<size_t>(config_.pop_batch, 1);
+        std::vector<WorkItem> batch;
+        batch.reserve(pop_batch);
+        
+        while (true) {
+            std::unique_lock<std::mutex> lock(cv_mutex_);
+            work_available_cv_.wait(lock, [this] {
+                return has_work() || should_retire() ||
+                       (!running_.load() && !has_outstanding());
+            });
+
+            if (!running_.load() && !has_outstanding()) break;
+            if (try_retire(worker_id)) {
+                LOG_INFO(std::format("Worker {} retired", worker_id));
+                return;
+            }
+
+            // Unlock to allow other workers to wake up
             lock.unlock();
 
-            // Try to fetch work
-            auto item_opt = router_.try_pop();
-            if (item_opt.has_value()) {
-                WorkItem item = std::move(item_opt.value());
-                process_item(worker_id, item);
-                metrics_.current_queue_depth.store(router_.total_size(), std::memory_order_relaxed);
+            // IO completions first: their wait is already paid for
+            if (auto done = pop_completion(); done.has_value()) {
+                finish_item(*done, true);
+            } else if (size_t expired = 0;
+                       router_.try_pop_batch(batch, pop_batch, &expired) > 0 || expired > 0) {
+                if (expired > 0) {
+                    metrics_.tasks_expired.add(expired);
+                }
+                // Freed slots go to parked producers first, in arrival order
+                if (waiting_.load(std::memory_order_acquire) > 0) drain_all_wait_lines();
+
+                uint64_t busy_start = now_ns();
+                for (const auto& item : batch) {
+                    metrics_.dequeue_age_us.record((busy_start - std::min(busy_start, item.created_at_ns)) / 1000);
+                }
+                for (auto& item : batch) {
+                    process_item(worker_id, std::move(item));
+                }
+                batch.clear();
+                worker_slots_[worker_id]->busy_ns.fetch_add(now_ns() - busy_start, std::memory_order_relaxed);
+            }
+
+            // Last item out during shutdown: release the other waiters
+            if (!running_.load() && !has_outstanding()) {
+                std::lock_guard<std::mutex> guard(cv_mutex_);
+                work_available_cv_.notify_all();
+                drain_cv_.notify_all();
             }
         }
         LOG_INFO(std::format("Worker {} exiting", worker_id));
     }
 
-    void process_item(size_t worker_id, const WorkItem& item) {
-        auto start = now_ns();
+    void process_item(size_t worker_id, WorkItem&& item) {
+        if (item.payload.type == TaskType::IO_BOUND && config_.async_io) {
+            auto io_wait = std::chrono::microseconds(100 * item.payload.complexity_score);
+            if (io_wheel_.schedule(std::move(item), io_wait)) {
+                metrics_.io_dispatched_async.add(1);
+                return;
+            }
+            metrics_.io_blocking_fallback.add(1);
+        }
 
         // Simulate work based on payload type
         bool success = true;
         try {
             switch (item.payload.type) {
                 case TaskType::CPU_INTENSIVE:
-                    // Matrix multiplication simulation
-                    simulate_cpu_load(item.payload.complexity_score);
+                    simulate_cpu_load(item);
                     break;
-                case TaskType::IO_BOUND:
-                    // Network wait simulation
+                case TaskType::IO_BOUND: {
+                    // Network wait simulation (sync mode or wheel saturated)
+                    uint64_t block_start = now_ns();
                     std::this_thread::sleep_for(std::chrono::microseconds(100 * item.payload.complexity_score));
+                    worker_slots_[worker_id]->blocked_ns.fetch_add(now_ns() - block_start, std::memory_order_relaxed);
                     break;
+                }
                 case TaskType::ADMINISTRATIVE:
                     // Fast path
                     break;
@@ -617,32 +2708,73 @@ private:
             success = false;
         }
 
+        finish_item(item, success);
+    }
+
+    // Runs on whichever worker took the item last: the one that processed
+    // it, or for an async IO item the one that popped its completion
+    void finish_item(const WorkItem& item, bool success) {
         auto end = now_ns();
-        uint64_t latency_us = (end - item.created_at_ns) / 1000;
+        uint64_t latency_us = (end - std::min(end, item.created_at_ns)) / 1000;
 
         // Update Stats
         circuit_breaker_.record_result(success);
         
         if (success) {
-            metrics_.tasks_processed.fetch_add(1, std::memory_order_relaxed);
+            metrics_.tasks_processed.add(1);
             metrics_.processing_latency_us.record(latency_us);
         } else {
-            metrics_.tasks_failed.fetch_add(1, std::memory_order_relaxed);
+            metrics_.tasks_failed.add(1);
         }
 
         // Trace logging for Critical items only to reduce noise
         if (item.priority == Priority::CRITICAL) {
             // Uncomment for verbose debugging
-            // LOG_INFO(std::format("Worker {} finished CRITICAL item {}", worker_id, item.id));
+            // LOG_INFO(std::format("Finished CRITICAL item {}", item.id));
         }
     }
 
-    void simulate_cpu_load(uint32_t difficulty) {
-        // Volatile to prevent compiler optimization
-        volatile double result = 0;
-        for (uint32_t i = 0; i < difficulty * 100; ++i) {
-            result += std::sin(i) * std::cos(i);
+    // Called on the timer wheel thread when an IO wait elapses
+    void on_io_complete(WorkItem&& item) {
+        {
+            std::lock_guard<std::mutex> lock(completions_mutex_);
+            completions_.push_back(std::move(item));
         }
+        completions_pending_.fetch_add(1, std::memory_order_release);
+
+        // Under cv_mutex_ so the wakeup cannot slip between a worker's
+        // predicate check and its wait during shutdown
+        std::lock_guard<std::mutex> lock(cv_mutex_);
+        work_available_cv_.notify_one();
+    }
+
+    // The wheel drops its in-flight count only after handing the item
+    // over, so a worker that finished the last completion may have gone
+    // back to sleep still seeing it. During shutdown, re-check everyone.
+    void on_io_idle() {
+        if (running_.load()) return;
+        std::lock_guard<std::mutex> lock(cv_mutex_);
+        work_available_cv_.notify_all();
+        drain_cv_.notify_all();
+    }
+
+    std::optional<WorkItem> pop_completion() {
+        if (completions_pending_.load(std::memory_order_acquire) == 0) return std::nullopt;
+
+        std::lock_guard<std::mutex> lock(completions_mutex_);
+        if (completions_.empty()) return std::nullopt;
+
+        WorkItem item = std::move(completions_.front());
+        completions_.pop_front();
+        completions_pending_.fetch_sub(1, std::memory_order_release);
+        return item;
+    }
+
+    void simulate_cpu_load(const WorkItem& item) {
+        const KernelSet& ks = config_.cpu_simd ? native_kernels() : scalar_kernels();
+        // Volatile to prevent compiler optimization
+        volatile uint64_t result = run_cpu_kernel(ks, config_.cpu_kernel, item.payload.complexity_score, item.id);
+        (void)result;
     }
 
     Config config_;
@@ -651,19 +2783,79 @@ private:
     SystemMetrics metrics_;
 
     std::atomic<bool> running_;
-    std::vector<std::jthread> workers_;
+
+    // Fixed slot table (max_workers); live slots hold running workers
+    std::vector<std::unique_ptr<WorkerSlot>> worker_slots_;
+    std::atomic<size_t> active_workers_{0};
+    std::atomic<size_t> target_workers_{0};
+    std::mutex pool_mutex_;
+    std::jthread scaler_thread_;
     std::mutex cv_mutex_;
     std::condition_variable work_available_cv_;
+    std::condition_variable drain_cv_; // stop() waiting for the drain to finish
+
+    // IO items whose wait elapsed, waiting for a worker to finish them
+    std::mutex completions_mutex_;
+    std::deque<WorkItem> completions_;
+    std::atomic<size_t> completions_pending_{0};
+
+    // Producers parked for capacity, one FIFO per priority level
+    std::array<WaitLine, PriorityRouter::kLevels> wait_lines_;
+    std::atomic<size_t> waiting_{0};
+
+    // Earliest deadline among parked submits, for the expiry thread
+    std::mutex expiry_mutex_;
+    std::condition_variable_any expiry_cv_;
+    Clock::time_point next_expiry_ = Clock::time_point::max();
+    std::jthread expiry_thread_;
+
+    // Declared last: its thread calls back into the members above
+    TimerWheel io_wheel_;
 };
 
 // ============================================================================
-// SECTION 8: PRODUCER SIMULATION
+// SECTION 11: PRODUCER SIMULATION
 // ============================================================================
 
+// Shared request mix for all simulated producers
+WorkItem make_simulated_item(std::mt19937& rng, uint32_t producer_id) {
+    std::uniform_int_distribution<uint32_t> prio_dist(0, 3);
+    std::uniform_int_distribution<uint32_t> type_dist(0, 2);
+    std::uniform_int_distribution<uint32_t> complexity_dist(10, 500);
+
+    WorkItem item;
+    item.id = SnowflakeId::generate();
+    item.created_at_ns = now_ns();
+    item.producer_id = producer_id;
+    
+    // Assign priority (weighted: fewer criticals)
+    int p_roll = prio_dist(rng);
+    if (p_roll == 0) item.priority = Priority::CRITICAL; // 25% chance
+    else if (p_roll == 1) item.priority = Priority::HIGH;
+    else item.priority = Priority::NORMAL; // Skew towards Normal
+
+    // Payload
+    item.payload.type = static_cast<TaskType>(type_dist(rng));
+    item.payload.complexity_score = complexity_dist(rng);
+    item.payload.metadata = "Simulated Request";
+    // Admin traffic is mostly "refresh X" signals over a small key space
+    if (item.payload.type == TaskType::ADMINISTRATIVE) item.coalesce_key = 1 + rng() % 64;
+    return item;
+}
+
+// Closed-loop: each thread waits for its own submit before scheduling the
+// next, so offered load drops whenever the engine slows down. Use
+// OpenLoopGenerator when the latency numbers matter.
 class ProducerGroup {
 public:
-    ProducerGroup(TitanEngine& engine, size_t count, std::string name)
-        : engine_(engine), count_(count), name_(std::move(name)) {}
+    ProducerGroup(TitanEngine& engine, size_t count, std::string name,
+                  uint32_t first_producer_id = 0)
+        : engine_(engine), count_(count), name_(std::move(name)),
+          first_producer_id_(first_producer_id) {}
+
+    // When set, a full level parks the producer for up to this long
+    // (submit_until) instead of dropping the item.
+    void set_admission_wait(Microseconds wait) { admission_wait_ = wait; }
 
     void start(uint64_t duration_ms) {
         for (size_t i = 0; i < count_; ++i) {
@@ -680,9 +2872,6 @@ public:
 private:
     void run(size_t id, uint64_t duration_ms) {
         std::mt19937 rng(std::random_device{}());
-        std::uniform_int_distribution<uint32_t> prio_dist(0, 3);
-        std::uniform_int_distribution<uint32_t> type_dist(0, 2);
-        std::uniform_int_distribution<uint32_t> complexity_dist(10, 500);
         
         // Burstiness parameters
         std::exponential_distribution<double> sleep_dist(1.0 / 500.0); // Avg 500us
@@ -690,24 +2879,12 @@ private:
         auto end_time = Clock::now() + std::chrono::milliseconds(duration_ms);
 
         while (Clock::now() < end_time) {
-            WorkItem item;
-            item.id = SnowflakeId::generate();
-            item.created_at_ns = now_ns();
-            item.producer_id = static_cast<uint32_t>(id);
-            
-            // Assign priority (weighted: fewer criticals)
-            int p_roll = prio_dist(rng);
-            if (p_roll == 0) item.priority = Priority::CRITICAL; // 25% chance
-            else if (p_roll == 1) item.priority = Priority::HIGH;
-            else item.priority = Priority::NORMAL; // Skew towards Normal
-
-            // Payload
-            item.payload.type = static_cast<TaskType>(type_dist(rng));
-            item.payload.complexity_score = complexity_dist(rng);
-            item.payload.metadata = "Simulated Request";
+            WorkItem item = make_simulated_item(rng, first_producer_id_ + static_cast<uint32_t>(id));
 
             // Submit to engine
-            if (!engine_.submit(std::move(item))) {
+            if (admission_wait_.count() > 0) {
+                engine_.submit_until(std::move(item), Clock::now() + admission_wait_);
+            } else if (!engine_.submit(std::move(item))) {
                 // If rejected, maybe backoff slightly?
                 std::this_thread::yield();
             }
@@ -721,20 +2898,555 @@ private:
     TitanEngine& engine_;
     size_t count_;
     std::string name_;
+    uint32_t first_producer_id_;
+    Microseconds admission_wait_{0};
     std::vector<std::jthread> threads_;
 };
 
+// --- Arrival Processes (open loop) ---
+// Each yields the gap to the next arrival, or nullopt when exhausted.
+
+struct PoissonArrivals {
+    double rate_per_sec;
+
+    std::optional<uint64_t> next_gap_ns(std::mt19937& rng) {
+        std::exponential_distribution<double> gap(rate_per_sec);
+        return static_cast<uint64_t>(gap(rng) * 1e9);
+    }
+};
+
+// Two-state Markov-modulated Poisson process: alternates between a base
+// and a burst rate, spending an exponentially distributed time in each.
+struct MmppArrivals {
+    double base_rate_per_sec;
+    double burst_rate_per_sec;
+    double mean_base_dwell_s;
+    double mean_burst_dwell_s;
+
+    bool in_burst = false;
+    double dwell_left_s = 0.0; // Drawn lazily on first use
+
+    std::optional<uint64_t> next_gap_ns(std::mt19937& rng) {
+        double gap_s = 0.0;
+        while (true) {
+            if (dwell_left_s <= 0.0) {
+                double mean = in_burst ? mean_burst_dwell_s : mean_base_dwell_s;
+                dwell_left_s = std::exponential_distribution<double>(1.0 / mean)(rng);
+            }
+
+            double rate = in_burst ? burst_rate_per_sec : base_rate_per_sec;
+            double t = rate > 0.0 ? std::exponential_distribution<double>(rate)(rng)
+                                  : std::numeric_limits<double>::infinity();
+            if (t <= dwell_left_s) {
+                dwell_left_s -= t;
+                return static_cast<uint64_t>((gap_s + t) * 1e9);
+            }
+
+            // No arrival before the state flips; memorylessness lets us
+            // redraw from the new state's rate
+            gap_s += dwell_left_s;
+            dwell_left_s = 0.0;
+            in_burst = !in_burst;
+        }
+    }
+};
+
+// Replays recorded arrival offsets (ascending, relative to start)
+struct TraceArrivals {
+    std::vector<uint64_t> offsets_ns;
+    size_t next = 0;
+    uint64_t last_ns = 0;
+
+    std::optional<uint64_t> next_gap_ns(std::mt19937&) {
+        if (next >= offsets_ns.size()) return std::nullopt;
+        uint64_t at = offsets_ns[next++];
+        uint64_t gap = at > last_ns ? at - last_ns : 0;
+        last_ns = std::max(last_ns, at);
+        return gap;
+    }
+
+    // One offset in microseconds per line; blank and '#' lines are skipped.
+    // Surrounding whitespace (including a CRLF's '\r') is ignored. Anything
+    // else that is not a whole number is reported with its line number.
+    static std::optional<TraceArrivals> from_file(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) {
+            std::cerr << "Cannot read trace file " << path << "\n";
+            return std::nullopt;
+        }
+
+        constexpr uint64_t kMaxUs = std::numeric_limits<uint64_t>::max() / 1000;
+        TraceArrivals trace;
+        std::string line;
+        for (size_t line_no = 1; std::getline(in, line); ++line_no) {
+            std::string_view text = line;
+            size_t first = text.find_first_not_of(" \t\r");
+            if (first == std::string_view::npos || text[first] == '#') continue;
+            text = text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+
+            uint64_t us = 0;
+            auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), us);
+            if (ec != std::errc{} || end != text.data() + text.size() || us > kMaxUs) {
+                std::cerr << path << ":" << line_no << ": bad arrival offset '" << text << "'\n";
+                return std::nullopt;
+            }
+            trace.offsets_ns.push_back(us * 1000);
+        }
+        return trace;
+    }
+};
+
+using ArrivalProcess = std::variant<PoissonArrivals, MmppArrivals, TraceArrivals>;
+
+// Open-loop generator: arrivals follow a precomputed schedule whatever the
+// engine does. When the sender falls behind it fires the backlog
+// back-to-back instead of skipping slots, and each item is stamped with
+// its *intended* send time, so engine latency includes any queueing the
+// generator itself suffered (no coordinated omission). Rejections are
+// counted and the item is dropped; there are no retries.
+class OpenLoopGenerator {
+public:
+    struct Stats {
+        std::atomic<uint64_t> attempted{0};
+        std::atomic<uint64_t> accepted{0};
+        std::atomic<uint64_t> rejected{0};
+        // How late each send was relative to its schedule (0 to 100ms)
+        Histogram send_lag_us{0, 100000, 100};
+    };
+
+    OpenLoopGenerator(TitanEngine& engine, ArrivalProcess arrivals,
+                      uint32_t producer_id, std::string name)
+        : engine_(engine), arrivals_(std::move(arrivals)),
+          producer_id_(producer_id), name_(std::move(name)) {}
+
+    void start(uint64_t duration_ms) {
+        thread_ = std::jthread(&OpenLoopGenerator::run, this, duration_ms);
+    }
+
+    void wait() {
+        if (thread_.joinable()) thread_.join();
+    }
+
+    const Stats& stats() const { return stats_; }
+    const std::string& name() const { return name_; }
+
+private:
+    void run(uint64_t duration_ms) {
+        std::mt19937 rng(std::random_device{}());
+
+        const uint64_t start = now_ns();
+        const uint64_t end = start + duration_ms * 1'000'000;
+        uint64_t intended = start;
+
+        while (true) {
+            auto gap = std::visit([&](auto& process) { return process.next_gap_ns(rng); }, arrivals_);
+            if (!gap.has_value()) break;
+            intended += *gap;
+            if (intended >= end) break;
+
+            uint64_t now = now_ns();
+            if (intended > now) {
+                std::this_thread::sleep_until(Clock::time_point(Nanoseconds(intended)));
+                now = now_ns();
+            }
+            stats_.send_lag_us.record(now > intended ? (now - intended) / 1000 : 0);
+
+            WorkItem item = make_simulated_item(rng, producer_id_);
+            item.created_at_ns = intended;
+
+            stats_.attempted.fetch_add(1, std::memory_order_relaxed);
+            if (engine_.submit(std::move(item))) {
+                stats_.accepted.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                stats_.rejected.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    TitanEngine& engine_;
+    ArrivalProcess arrivals_;
+    uint32_t producer_id_;
+    std::string name_;
+    Stats stats_;
+    std::jthread thread_;
+};
+
+// ============================================================================
+// SECTION 12: SHARED-MEMORY INGESTION
+// ============================================================================
+// Lets other processes on the host submit without a socket. The engine owns
+// a ring of fixed-layout records in a /dev/shm file; producers map it and
+// publish with a CAS on the head plus a per-slot sequence number (bounded
+// MPMC scheme, single consumer here). The engine-side pump grants credits:
+// producers may only reserve positions below credit_limit, which the pump
+// keeps at (read position + engine headroom), so a saturated engine pushes
+// back into the producers instead of filling the ring with items it would
+// reject. No syscalls on the fast path: futexes are only touched when the
+// pump sleeps on an empty ring or a producer waits for credit.
+//
+// A producer that dies between reserving and publishing a slot stalls the
+// ring; the pump does not try to recover from that.
+
+#if defined(__linux__)
+
+// Process-independent image of a WorkItem
+struct ShmRecord {
+    uint64_t id;
+    uint64_t created_at_ns; // CLOCK_MONOTONIC, comparable across processes
+    uint64_t coalesce_key;
+    uint32_t producer_id;
+    uint32_t complexity_score;
+    uint8_t priority;
+    uint8_t type;
+    uint8_t metadata_len;
+    char metadata[23];
+    uint8_t reserved[6];
+
+    static ShmRecord from(const WorkItem& item) {
+        ShmRecord rec{};
+        rec.id = item.id;
+        rec.created_at_ns = item.created_at_ns;
+        rec.coalesce_key = item.coalesce_key;
+        rec.producer_id = item.producer_id;
+        rec.complexity_score = item.payload.complexity_score;
+        rec.priority = static_cast<uint8_t>(item.priority);
+        rec.type = static_cast<uint8_t>(item.payload.type);
+        auto meta = item.payload.metadata.view();
+        rec.metadata_len = static_cast<uint8_t>(meta.size());
+        std::memcpy(rec.metadata, meta.data(), meta.size());
+        return rec;
+    }
+
+    // Fields are clamped: the writer is another process and is not trusted
+    // to keep enums in range, nor to stamp a creation time that is not in
+    // our future
+    WorkItem to_item() const {
+        WorkItem item;
+        item.id = id;
+        item.created_at_ns = std::min(created_at_ns, now_ns());
+        item.coalesce_key = coalesce_key;
+        item.producer_id = producer_id;
+        item.priority = static_cast<Priority>(std::min<uint8_t>(priority, static_cast<uint8_t>(Priority::LOW)));
+        item.payload.complexity_score = std::min<uint32_t>(complexity_score, 1000);
+        item.payload.type = static_cast<TaskType>(std::min<uint8_t>(type, static_cast<uint8_t>(TaskType::ADMINISTRATIVE)));
+        item.payload.metadata = std::string_view(metadata, std::min<size_t>(metadata_len, sizeof(metadata)));
+        return item;
+    }
+};
+
+static_assert(sizeof(ShmRecord) == 64 && std::is_trivially_copyable_v<ShmRecord>);
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "ring atomics must be address-free to work across processes");
+
+class ShmRing {
+public:
+    static constexpr uint64_t kMagic = 0x54495441'4E524E47; // "TITANRNG"
+    static constexpr uint32_t kVersion = 1;
+
+    enum class Status { OK, NO_CREDIT, TIMED_OUT };
+
+    // Engine side: creates (or replaces) /dev/shm/<name> with `capacity`
+    // slots, rounded up to a power of two. Null on failure.
+    static std::unique_ptr<ShmRing> create(const std::string& name, size_t capacity) {
+        capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+        size_t bytes = sizeof(Header) + capacity * sizeof(Slot);
+
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0600);
+        if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            LOG_ERR(std::format("shm ring {}: create failed: {}", name, std::strerror(errno)));
+            if (fd >= 0) ::close(fd);
+            return nullptr;
+        }
+        auto ring = map(name, fd, bytes, true);
+        if (!ring) return nullptr;
+
+        // ftruncate zero-fills, so atomics start at 0; slots need their lap-0 sequence
+        Header* h = ring->header_;
+        for (uint64_t i = 0; i < capacity; ++i) ring->slots_[i].seq.store(i, std::memory_order_relaxed);
+        h->capacity = capacity;
+        h->slot_size = sizeof(Slot);
+        h->version = kVersion;
+        h->magic = kMagic; // Last: attachers check it
+        std::atomic_thread_fence(std::memory_order_release);
+        ring->mask_ = capacity - 1;
+        return ring;
+    }
+
+    // Producer side: maps an existing ring. Null if missing or incompatible.
+    static std::unique_ptr<ShmRing> attach(const std::string& name) {
+        int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+        struct stat st {};
+        if (fd < 0 || ::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+            if (fd >= 0) ::close(fd);
+            return nullptr;
+        }
+        auto ring = map(name, fd, static_cast<size_t>(st.st_size), false);
+        if (!ring) return nullptr;
+
+        const Header* h = ring->header_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (h->magic != kMagic || h->version != kVersion || h->slot_size != sizeof(Slot) ||
+            !std::has_single_bit(h->capacity) ||
+            sizeof(Header) + h->capacity * sizeof(Slot) > static_cast<size_t>(st.st_size)) {
+            return nullptr;
+        }
+        ring->mask_ = h->capacity - 1;
+        return ring;
+    }
+
+    ~ShmRing() {
+        ::munmap(base_, bytes_);
+        ::close(fd_);
+        if (owner_) ::shm_unlink(name_.c_str());
+    }
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // --- Producer API ---
+
+    // Publishes one item if the engine has granted credit for it
+    Status try_submit(const WorkItem& item) {
+        Header* h = header_;
+        uint64_t pos = h->head.load(std::memory_order_relaxed);
+        while (true) {
+            if (pos >= h->credit_limit.load(std::memory_order_acquire)) return Status::NO_CREDIT;
+            Slot& slot = slots_[pos & mask_];
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq == pos) {
+                if (h->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (seq < pos) {
+                return Status::NO_CREDIT; // Slot not yet consumed from the last lap
+            } else {
+                pos = h->head.load(std::memory_order_relaxed);
+            }
+        }
+
+        Slot& slot = slots_[pos & mask_];
+        slot.record = ShmRecord::from(item);
+        slot.seq.store(pos + 1, std::memory_order_release);
+
+        // Pairs with the fence in Pump::idle_wait: either the pump sees the
+        // record, or we see it asleep and wake it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (h->pump_sleeping.load(std::memory_order_relaxed) != 0 &&
+            h->pump_sleeping.exchange(0, std::memory_order_relaxed) != 0) {
+            futex_wake(h->pump_sleeping, 1);
+        }
+        return Status::OK;
+    }
+
+    // Blocks (futex) while out of credit, for at most `timeout`
+    Status submit_wait(const WorkItem& item, Milliseconds timeout) {
+        Header* h = header_;
+        auto deadline = Clock::now() + timeout;
+        while (true) {
+            uint32_t epoch = h->credit_epoch.load(std::memory_order_acquire);
+            if (try_submit(item) == Status::OK) return Status::OK;
+
+            auto now = Clock::now();
+            if (now >= deadline) return Status::TIMED_OUT;
+            h->credit_waiters.fetch_add(1, std::memory_order_seq_cst);
+            futex_wait(h->credit_epoch, epoch, deadline - now);
+            h->credit_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    friend class ShmIngestPump;
+
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t slot_size;
+        uint64_t capacity;
+
+        alignas(64) std::atomic<uint64_t> head;         // Next position to reserve
+        alignas(64) std::atomic<uint64_t> tail;         // Next position the pump reads
+        std::atomic<uint64_t> credit_limit;             // Reservations must stay below
+        alignas(64) std::atomic<uint32_t> pump_sleeping; // Futex word
+        alignas(64) std::atomic<uint32_t> credit_epoch;  // Futex word, bumped per grant
+        std::atomic<uint32_t> credit_waiters;
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq; // pos: free, pos + 1: published
+        ShmRecord record;
+    };
+
+    ShmRing(std::string name, int fd, void* base, size_t bytes, bool owner)
+        : name_(std::move(name)), fd_(fd), base_(base), bytes_(bytes), owner_(owner),
+          header_(static_cast<Header*>(base)),
+          slots_(reinterpret_cast<Slot*>(static_cast<char*>(base) + sizeof(Header))) {}
+
+    static std::unique_ptr<ShmRing> map(const std::string& name, int fd, size_t bytes, bool owner) {
+        void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            LOG_ERR(std::format("shm ring {}: mmap failed: {}", name, std::strerror(errno)));
+            ::close(fd);
+            if (owner) ::shm_unlink(name.c_str());
+            return nullptr;
+        }
+        return std::unique_ptr<ShmRing>(new ShmRing(name, fd, base, bytes, owner));
+    }
+
+    // Shared (not PRIVATE) futex ops: waiters live in other processes
+    static void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, Clock::duration timeout) {
+        auto ns = std::chrono::duration_cast<Nanoseconds>(timeout).count();
+        timespec ts{static_cast<time_t>(ns / 1'000'000'000), static_cast<long>(ns % 1'000'000'000)};
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+    }
+
+    static void futex_wake(std::atomic<uint32_t>& word, int count) {
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, count, nullptr, nullptr, 0);
+    }
+
+    std::string name_;
+    int fd_;
+    void* base_;
+    size_t bytes_;
+    bool owner_;
+    Header* header_;
+    Slot* slots_;
+    uint64_t mask_ = 0;
+};
+
+// Engine side of a ShmRing: moves published records into the engine in
+// batches and turns engine headroom into producer credit.
+class ShmIngestPump {
+public:
+    struct Stats {
+        std::atomic<uint64_t> ingested{0};      // Records taken off the ring
+        std::atomic<uint64_t> engine_refused{0}; // Batch retries after a refusal
+        std::atomic<uint64_t> wakeups{0};       // Futex sleeps that ended
+    };
+
+    ShmIngestPump(TitanEngine& engine, ShmRing& ring, size_t batch = 64)
+        : engine_(engine), ring_(ring), batch_(std::max<size_t>(batch, 1)) {
+        held_.reserve(batch_);
+    }
+
+    ~ShmIngestPump() { stop(); }
+
+    void start() {
+        grant_credits();
+        thread_ = std::jthread([this](std::stop_token st) { run(st); });
+    }
+
+    // Stop before the engine: items still in the ring stay there
+    void stop() {
+        if (!thread_.joinable()) return;
+        thread_.request_stop();
+        auto* h = ring_.header_;
+        h->pump_sleeping.store(0, std::memory_order_relaxed);
+        ShmRing::futex_wake(h->pump_sleeping, 1);
+        thread_.join();
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    void run(std::stop_token st) {
+        while (!st.stop_requested()) {
+            // Items the engine refused go first, so ring order is kept
+            if (held_.empty()) pull();
+            size_t offered = held_.size();
+            if (offered > 0) {
+                size_t taken = engine_.offer_batch(held_);
+                held_.erase(held_.begin(), held_.begin() + static_cast<std::ptrdiff_t>(taken));
+                if (!held_.empty()) stats_.engine_refused.fetch_add(1, std::memory_order_relaxed);
+            }
+            grant_credits();
+
+            if (!held_.empty()) {
+                // Engine full: wait for workers to make room
+                std::this_thread::sleep_for(Microseconds(100));
+            } else if (offered == 0) {
+                idle_wait();
+            }
+        }
+    }
+
+    void pull() {
+        auto* h = ring_.header_;
+        uint64_t tail = h->tail.load(std::memory_order_relaxed);
+        while (held_.size() < batch_) {
+            auto& slot = ring_.slots_[tail & ring_.mask_];
+            if (slot.seq.load(std::memory_order_acquire) != tail + 1) break;
+            held_.push_back(slot.record.to_item());
+            levels_ |= 1u << static_cast<unsigned>(held_.back().priority);
+            // Free the slot for the producer one lap ahead
+            slot.seq.store(tail + ring_.capacity(), std::memory_order_release);
+            tail++;
+        }
+        stats_.ingested.fetch_add(held_.size(), std::memory_order_relaxed);
+        h->tail.store(tail, std::memory_order_release);
+    }
+
+    // Credit = the least room, less what we hold there, over the levels the
+    // ring has carried (all of them until it has carried any), capped by the
+    // ring. Producers pick the level, so room at one level is no promise for
+    // another. Only ever raised, so no reservation is revoked.
+    void grant_credits() {
+        auto* h = ring_.header_;
+        std::array<size_t, PriorityRouter::kLevels> holding{};
+        for (const auto& item : held_) holding[static_cast<size_t>(item.priority)]++;
+        size_t headroom = std::numeric_limits<size_t>::max();
+        for (size_t lvl = 0; lvl < PriorityRouter::kLevels; ++lvl) {
+            if (levels_ != 0 && (levels_ & (1u << lvl)) == 0) continue;
+            size_t room = engine_.admission_headroom(static_cast<Priority>(lvl));
+            headroom = std::min(headroom, room > holding[lvl] ? room - holding[lvl] : 0);
+        }
+        uint64_t limit = h->tail.load(std::memory_order_relaxed) + std::min(headroom, ring_.capacity());
+        if (limit <= h->credit_limit.load(std::memory_order_relaxed)) return;
+
+        h->credit_limit.store(limit, std::memory_order_release);
+        h->credit_epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (h->credit_waiters.load(std::memory_order_seq_cst) > 0) {
+            ShmRing::futex_wake(h->credit_epoch, std::numeric_limits<int>::max());
+        }
+    }
+
+    void idle_wait() {
+        auto* h = ring_.header_;
+        // With producers waiting on credit, poll the engine for room often
+        auto timeout = h->credit_waiters.load(std::memory_order_relaxed) > 0 ? Milliseconds(1) : Milliseconds(100);
+
+        h->pump_sleeping.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t tail = h->tail.load(std::memory_order_relaxed);
+        if (ring_.slots_[tail & ring_.mask_].seq.load(std::memory_order_acquire) != tail + 1) {
+            ShmRing::futex_wait(h->pump_sleeping, 1, timeout);
+            stats_.wakeups.fetch_add(1, std::memory_order_relaxed);
+        }
+        h->pump_sleeping.store(0, std::memory_order_relaxed);
+    }
+
+    TitanEngine& engine_;
+    ShmRing& ring_;
+    size_t batch_;
+    std::vector<WorkItem> held_;
+    unsigned levels_ = 0; // Priorities seen on the ring, one bit each
+    Stats stats_;
+    std::jthread thread_;
+};
+
+#endif // __linux__
+
 // ============================================================================
-// SECTION 9: REPORTING & MAIN
+// SECTION 13: REPORTING & MAIN
 // ============================================================================
 
 void print_final_report(const TitanEngine& engine, double duration_s) {
     const auto& m = engine.get_metrics();
+    const MetricsSnapshot snap = engine.snapshot();
     
-    uint64_t total = m.tasks_submitted.load();
-    uint64_t processed = m.tasks_processed.load();
-    uint64_t q_rej = m.tasks_rejected_queue_full.load();
-    uint64_t c_rej = m.tasks_rejected_circuit_open.load();
+    uint64_t total = snap.tasks_submitted;
+    uint64_t processed = snap.tasks_processed;
+    uint64_t q_rej = snap.tasks_rejected_queue_full;
+    uint64_t c_rej = snap.tasks_rejected_circuit_open;
     
     std::cout << "\n";
     std::cout << "========================================================\n";
@@ -747,31 +3459,307 @@ void print_final_report(const TitanEngine& engine, double duration_s) {
     std::cout << "\n--- Volume ---\n";
     std::cout << "Total Submitted:    " << total << "\n";
     std::cout << "Processed Success:  " << processed << "\n";
-    std::cout << "Failures (Internal):" << m.tasks_failed.load() << "\n";
+    std::cout << "Failures (Internal):" << snap.tasks_failed << "\n";
+    std::cout << "Coalesced:          " << snap.tasks_coalesced << "\n";
     
     std::cout << "\n--- Rejection (Backpressure) ---\n";
     std::cout << "Queue Full Rejects: " << q_rej << " (" 
               << (total ? (100.0 * q_rej / total) : 0.0) << "%)\n";
+    std::cout << "  of which Fairness:" << snap.tasks_rejected_fairness << "\n";
     std::cout << "Circuit Breaks:     " << c_rej << "\n";
+    std::cout << "Evicted (Reclaim):  " << snap.tasks_evicted << "\n";
+    std::cout << "Shed (Shutdown):    " << snap.tasks_shed << "\n";
+    std::cout << "Expired (TTL):      " << snap.tasks_expired << "\n";
+
+    std::cout << "\n--- Parked Admission ---\n";
+    std::cout << "Admitted (Waited):  " << snap.admitted_after_wait << "\n";
+    std::cout << "Timed Out:          " << snap.admission_timed_out << "\n";
+    std::cout << "Failed Fast:        " << snap.admission_failed_fast << "\n";
+
+    std::cout << "\n--- IO Path ---\n";
+    std::cout << "Async (Wheel):      " << snap.io_dispatched_async << "\n";
+    std::cout << "Blocking Fallback:  " << snap.io_blocking_fallback << "\n";
+
+    std::cout << "\n--- Worker Pool ---\n";
+    std::cout << "Final Workers:      " << snap.active_workers << "\n";
+    std::cout << "Grow / Shrink:      " << m.pool_grow_events.load()
+              << " / " << m.pool_shrink_events.load() << "\n";
     
     std::cout << "\n--- Latency (us) ---\n";
     std::cout << "Mean Latency:       " << m.processing_latency_us.get_mean() << " us\n";
     std::cout << "P50  Latency:       " << m.processing_latency_us.get_percentile(0.50) << " us\n";
     std::cout << "P90  Latency:       " << m.processing_latency_us.get_percentile(0.90) << " us\n";
     std::cout << "P99  Latency:       " << m.processing_latency_us.get_percentile(0.99) << " us\n";
+    std::cout << "P50  Queue Age:     " << m.dequeue_age_us.get_percentile(0.50) << " us\n";
+    std::cout << "P99  Queue Age:     " << m.dequeue_age_us.get_percentile(0.99) << " us\n";
     std::cout << "========================================================\n";
 }
 
-int main() {
+// --- ADMINISTRATIVE fast-path benchmark (--bench-batch) ---
+// Producers push zero-cost items as fast as the router accepts them, first
+// one submit()/pop per item, then submit_batch()/pop_batch of `batch` items.
+double run_admin_throughput(size_t batch, size_t producers, size_t items_per_producer) {
+    TitanEngine::Config config;
+    config.queue_capacity = 2000;
+    config.num_workers = std::max(1u, std::thread::hardware_concurrency());
+    config.pop_batch = batch;
+    TitanEngine engine(config);
+
+    auto make_item = [](uint32_t producer) {
+        WorkItem item;
+        item.id = SnowflakeId::generate();
+        item.created_at_ns = now_ns();
+        item.producer_id = producer;
+        item.priority = Priority::NORMAL;
+        item.payload.type = TaskType::ADMINISTRATIVE;
+        item.payload.complexity_score = 0;
+        return item;
+    };
+
+    auto start = Clock::now();
+    {
+        std::vector<std::jthread> threads;
+        for (size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                auto producer = static_cast<uint32_t>(p);
+                if (batch <= 1) {
+                    for (size_t i = 0; i < items_per_producer; ++i) {
+                        while (!engine.submit(make_item(producer))) std::this_thread::yield();
+                    }
+                    return;
+                }
+                std::vector<WorkItem> items(batch);
+                for (size_t sent = 0; sent < items_per_producer;) {
+                    size_t n = std::min(batch, items_per_producer - sent);
+                    for (size_t i = 0; i < n; ++i) items[i] = make_item(producer);
+                    std::span<WorkItem> pending(items.data(), n);
+                    while (!pending.empty()) {
+                        size_t taken = engine.submit_batch(pending);
+                        pending = pending.subspan(taken);
+                        if (!pending.empty()) std::this_thread::yield();
+                    }
+                    sent += n;
+                }
+            });
+        }
+    }
+
+    const uint64_t total = producers * items_per_producer;
+    while (engine.get_metrics().tasks_processed.load() < total) {
+        std::this_thread::yield();
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    engine.stop();
+    return total / elapsed.count();
+}
+
+void run_batch_benchmark() {
+    constexpr size_t kProducers = 4;
+    constexpr size_t kItemsPerProducer = 250'000;
+
+    double single = run_admin_throughput(1, kProducers, kItemsPerProducer);
+    double batched = run_admin_throughput(64, kProducers, kItemsPerProducer);
+    AsyncLogger::instance().shutdown();
+
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "\n--- ADMINISTRATIVE Fast Path (" << kProducers * kItemsPerProducer << " items) ---\n";
+    std::cout << "Single submit/pop:  " << single << " ops/sec\n";
+    std::cout << "Batch of 64:        " << batched << " ops/sec\n";
+    std::cout << std::setprecision(2);
+    std::cout << "Speedup:            " << (batched / single) << "x\n";
+}
+
+// --- CPU kernel benchmark (--bench-kernels) ---
+// Runs each kernel on the portable and the native path at a fixed
+// difficulty and checks that both agree.
+void run_kernel_benchmark() {
+    constexpr uint32_t kDifficulty = 256;
+    constexpr int kReps = 200;
+    constexpr std::pair<CpuKernel, const char*> kKernels[] = {
+        {CpuKernel::HASH, "Hash"}, {CpuKernel::COMPRESS, "Compress"},
+        {CpuKernel::GEMM, "GEMM"}, {CpuKernel::PARSE, "Parse"}, {CpuKernel::TRIG, "Trig (legacy)"}};
+
+    const KernelSet& scalar = scalar_kernels();
+    const KernelSet& native = native_kernels();
+    auto time_us = [](const KernelSet& ks, CpuKernel kernel, uint64_t& result) {
+        auto start = Clock::now();
+        for (int r = 0; r < kReps; ++r) result = run_cpu_kernel(ks, kernel, kDifficulty, 0);
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / kReps;
+    };
+
+    std::cout << "\n--- CPU Kernels (difficulty " << kDifficulty << ", native = " << native.isa << ") ---\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (auto [kernel, name] : kKernels) {
+        uint64_t scalar_result = 0, native_result = 0;
+        double scalar_us = time_us(scalar, kernel, scalar_result);
+        double native_us = time_us(native, kernel, native_result);
+        bool same = kernel == CpuKernel::GEMM
+                        ? std::abs(static_cast<double>(scalar_result) - static_cast<double>(native_result)) <= 1.0
+                        : scalar_result == native_result;
+        std::cout << std::left << std::setw(15) << name << std::right
+                  << std::setw(9) << scalar_us << " us  ->" << std::setw(9) << native_us << " us  ("
+                  << std::setprecision(2) << (scalar_us / native_us) << "x)"
+                  << (same ? "" : "  RESULT MISMATCH") << "\n" << std::setprecision(1);
+    }
+}
+
+#if defined(__linux__)
+// --- Cross-process ingestion benchmark (--bench-shm) ---
+// Forked producer processes attach to the ring by name and push zero-cost
+// items; the parent engine ingests them through ShmIngestPump.
+void run_shm_benchmark() {
+    constexpr size_t kProducers = 2;
+    constexpr size_t kItemsPerProducer = 250'000;
+    const std::string name = std::format("/titan_gate_ingest_{}", ::getpid());
+
+    auto ring = ShmRing::create(name, 4096);
+    if (!ring) {
+        std::cerr << "Cannot create shared-memory ring " << name << "\n";
+        return;
+    }
+
+    // Fork before the engine starts any threads
+    std::vector<pid_t> children;
+    for (size_t p = 0; p < kProducers; ++p) {
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            auto producer_ring = ShmRing::attach(name);
+            if (!producer_ring) ::_exit(2);
+            for (size_t i = 0; i < kItemsPerProducer; ++i) {
+                WorkItem item;
+                item.id = (uint64_t{p} << 48) | i;
+                item.created_at_ns = now_ns();
+                item.producer_id = static_cast<uint32_t>(1000 + p);
+                item.priority = Priority::NORMAL;
+                item.payload.type = TaskType::ADMINISTRATIVE;
+                item.payload.complexity_score = 0;
+                if (producer_ring->submit_wait(item, Milliseconds(10'000)) != ShmRing::Status::OK) ::_exit(1);
+            }
+            ::_exit(0);
+        }
+        if (pid > 0) children.push_back(pid);
+    }
+
+    TitanEngine::Config config;
+    config.queue_capacity = 2000;
+    config.num_workers = std::max(1u, std::thread::hardware_concurrency());
+    config.pop_batch = 64;
+    TitanEngine engine(config);
+    ShmIngestPump pump(engine, *ring);
+
+    auto start = Clock::now();
+    pump.start();
+    const uint64_t total = children.size() * kItemsPerProducer;
+    auto give_up = start + std::chrono::seconds(60);
+    while (engine.get_metrics().tasks_processed.load() < total && Clock::now() < give_up) {
+        std::this_thread::sleep_for(Milliseconds(1));
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    uint64_t processed = engine.get_metrics().tasks_processed.load();
+
+    size_t failed = 0;
+    for (pid_t pid : children) {
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed++;
+    }
+    pump.stop();
+    engine.stop();
+    AsyncLogger::instance().shutdown();
+
+    const auto& st = pump.stats();
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "\n--- Shared-Memory Ingestion (" << children.size() << " processes, ring "
+              << ring->capacity() << ") ---\n";
+    std::cout << "Processed:          " << processed << " / " << total << "\n";
+    std::cout << "Throughput:         " << (processed / elapsed.count()) << " ops/sec\n";
+    std::cout << "Engine Refusals:    " << st.engine_refused.load() << "\n";
+    std::cout << "Pump Wakeups:       " << st.wakeups.load() << "\n";
+    std::cout << "Failed Producers:   " << failed << "\n";
+}
+#endif
+
+void print_open_loop_report(const OpenLoopGenerator& gen, double duration_s) {
+    const auto& st = gen.stats();
+    uint64_t attempted = st.attempted.load();
+    uint64_t rejected = st.rejected.load();
+
+    std::cout << "\n--- Open-Loop Generator (" << gen.name() << ") ---\n";
+    std::cout << "Offered Rate:       " << (attempted / duration_s) << " req/sec\n";
+    std::cout << "Attempted:          " << attempted << "\n";
+    std::cout << "Accepted:           " << st.accepted.load() << "\n";
+    std::cout << "Rejected:           " << rejected << " ("
+              << (attempted ? (100.0 * rejected / attempted) : 0.0) << "%)\n";
+    std::cout << "Send Lag P99:       " << st.send_lag_us.get_percentile(0.99) << " us\n";
+}
+
+// --open-loop poisson | mmpp | trace <file>
+// Leaves `out` empty for a closed-loop run. Returns false when --open-loop
+// was given but its arguments are unusable, so main can refuse to start.
+bool parse_arrivals(int argc, char** argv, std::optional<ArrivalProcess>& out) {
+    if (argc < 2 || std::string_view(argv[1]) != "--open-loop") return true;
+
+    std::string_view kind = argc > 2 ? argv[2] : "";
+    if (kind == "poisson") {
+        out = PoissonArrivals{10'000.0};
+    } else if (kind == "mmpp") {
+        out = MmppArrivals{5'000.0, 40'000.0, 0.4, 0.1};
+    } else if (kind == "trace") {
+        if (argc < 4) {
+            std::cerr << "--open-loop trace needs a file\n";
+            return false;
+        }
+        auto trace = TraceArrivals::from_file(argv[3]);
+        if (!trace) return false;
+        out = std::move(*trace);
+    } else {
+        std::cerr << "Unknown arrival process '" << kind << "' (poisson | mmpp | trace <file>)\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string_view(argv[1]) == "--bench-batch") {
+        run_batch_benchmark();
+        return 0;
+    }
+#if defined(__linux__)
+    if (argc > 1 && std::string_view(argv[1]) == "--bench-shm") {
+        run_shm_benchmark();
+        return 0;
+    }
+#endif
+    if (argc > 1 && std::string_view(argv[1]) == "--bench-kernels") {
+        run_kernel_benchmark();
+        AsyncLogger::instance().shutdown();
+        return 0;
+    }
+
+    std::optional<ArrivalProcess> arrivals;
+    if (!parse_arrivals(argc, argv, arrivals)) return 1;
+
     // Configure System
     TitanEngine::Config config;
     config.queue_capacity = 2000;
     config.num_workers = std::thread::hardware_concurrency(); 
     config.circuit_failure_rate = 0.2; // Strict breaker
+    config.dequeue_policy.mode = DequeuePolicy::WEIGHTED_DEFICIT;
+    config.capacity_policy.shared = true;
+    config.capacity_policy.per_producer_fair = true;
+    config.capacity_policy.coalesce = true;
+    config.dequeue_policy.ttl_us = {20'000, 50'000, 100'000, 500'000};
+    config.autoscale.enabled = true;
+    config.autoscale.min_workers = 1;
+    config.autoscale.max_workers = 4 * config.num_workers;
+    config.drain.deadline = Milliseconds(500);
 
     std::cout << "Starting TITAN GATE System...\n";
     std::cout << "Workers: " << config.num_workers << "\n";
     std::cout << "Buffer:  " << config.queue_capacity << "\n";
+    std::cout << "Dequeue: "
+              << (config.dequeue_policy.mode == DequeuePolicy::STRICT ? "STRICT" : "WEIGHTED_DEFICIT")
+              << "\n";
 
     TitanEngine engine(config);
 
@@ -780,27 +3768,43 @@ int main() {
     ProducerGroup web_producers(engine, 4, "WebFrontend");
     
     // Group 2: Heavy Batch jobs (lower frequency, high cost)
-    ProducerGroup batch_producers(engine, 2, "BatchBackend");
+    ProducerGroup batch_producers(engine, 2, "BatchBackend", 100);
+    batch_producers.set_admission_wait(Milliseconds(5));
 
     auto start_time = Clock::now();
 
+    // Open-loop mode replaces the closed-loop producer groups
+    std::optional<OpenLoopGenerator> open_loop;
+
     // Start Simulation
     LOG_INFO("Starting Producers...");
-    web_producers.start(5000);   // Run for 5 seconds
-    batch_producers.start(5000); // Run for 5 seconds
+    if (arrivals.has_value()) {
+        open_loop.emplace(engine, std::move(*arrivals), 0, "OpenLoop");
+        open_loop->start(5000);
+    } else {
+        web_producers.start(5000);   // Run for 5 seconds
+        batch_producers.start(5000); // Run for 5 seconds
+    }
 
     // Monitor Loop (runs on main thread)
+    MetricsSnapshot last = engine.snapshot();
     for (int i = 0; i < 5; ++i) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
-        auto depth = engine.get_metrics().current_queue_depth.load();
-        auto processed = engine.get_metrics().tasks_processed.load();
-        std::cout << "[Monitor] Queue Depth: " << depth 
-                  << " | Processed: " << processed << "\n";
+        MetricsSnapshot now = engine.snapshot();
+        MetricsSnapshot d = now.delta_since(last);
+        last = now;
+        std::cout << "[Monitor] Queue Depth: " << now.queue_depth 
+                  << " | Processed: " << now.tasks_processed
+                  << " (+" << static_cast<uint64_t>(d.tasks_processed / d.window_s()) << "/s)"
+                  << " | Rejected: +" << d.tasks_rejected_queue_full
+                  << " | Expired: +" << d.tasks_expired
+                  << " | Workers: " << now.active_workers << "\n";
     }
 
     // Join Producers
     web_producers.wait();
     batch_producers.wait();
+    if (open_loop) open_loop->wait();
     
     auto end_time = Clock::now();
     std::chrono::duration<double> diff = end_time - start_time;
@@ -812,6 +3816,7 @@ int main() {
     AsyncLogger::instance().shutdown();
 
     print_final_report(engine, diff.count());
+    if (open_loop) print_open_loop_report(*open_loop, diff.count());
 
     return 0;
 }
\ No newline at end of file
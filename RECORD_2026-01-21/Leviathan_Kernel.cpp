@@ -20,9 +20,9 @@
  * [CORE]      SpinLocks, Atomics, UUID, SIMD Utils
  * [CRYPTO]    integrity_hash (SHA-256 simplified variant)
  * [MEM]       Slab, Arena, & Buddy Allocators
- * [STM]       Software Transactional Memory (MVCC)
- * [VFS]       In-Memory Virtual File System (Inode/Dentry)
- * [NET]       Zero-Copy Ring Buffer Network Stack
+ * [STM]       Software Transactional Memory (TL2)
+ * [VFS]       Virtual File System (Inode/Dentry) over a Journaled mmap Image
+ * [NET]       Zero-Copy Network Stack (Lock-Free Descriptor Rings, Pooled Buffers)
  * [SCHED]     Multi-Level Feedback Queue (MLFQ) with Task Coloring
  * [EXEC]      Work-Stealing Thread Pool with Fiber Support
  * [HAL]       Hardware Abstraction Layer (Mock DMA/MMIO)
@@ -39,6 +39,7 @@
 #include <bit>
 #include <barrier>
 #include <cassert>
+#include <cerrno>
 #include <chrono>
 #include <cmath>
 #include <concepts>
@@ -49,6 +50,7 @@
 #include <exception>
 #include <execution>
 #include <filesystem>
+#include <fstream>
 #include <format>
 #include <functional>
 #include <iostream>
@@ -90,6 +92,8 @@
     #include <unistd.h>
     #include <pthread.h>
     #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
 #endif
 
 // =====================================================================================================================
@@ -169,6 +173,149 @@ namespace Leviathan {
         ~SpinGuard() { lock_.unlock(); }
     };
 
+    // --- Thread Slot Registry ---
+    // Dense index for each live thread, so per-thread state can live in fixed arrays instead of
+    // thread_local maps. Slots are recycled when a thread exits; threads past LEVIATHAN_MAX_THREADS
+    // get kNoSlot and must take the shared path.
+    class ThreadSlot {
+        static_assert(LEVIATHAN_MAX_THREADS <= 64, "slot bitmap is one word");
+    public:
+        static constexpr size_t kNoSlot = LEVIATHAN_MAX_THREADS;
+
+        static size_t index() {
+            thread_local Holder holder;
+            return holder.slot;
+        }
+
+    private:
+        static std::atomic<uint64_t>& used() {
+            static std::atomic<uint64_t> bits{0};
+            return bits;
+        }
+
+        struct Holder {
+            size_t slot = kNoSlot;
+            Holder() {
+                constexpr uint64_t all = LEVIATHAN_MAX_THREADS == 64 ? ~uint64_t{0}
+                                                                      : (uint64_t{1} << LEVIATHAN_MAX_THREADS) - 1;
+                uint64_t bits = used().load(std::memory_order_relaxed);
+                while (uint64_t free_bits = ~bits & all) {
+                    size_t s = std::countr_zero(free_bits);
+                    if (used().compare_exchange_weak(bits, bits | (uint64_t{1} << s), std::memory_order_acq_rel)) {
+                        slot = s;
+                        return;
+                    }
+                }
+            }
+            // Release pairs with the next owner's acquire, handing over whatever it left in the slot
+            ~Holder() {
+                if (slot != kNoSlot) used().fetch_and(~(uint64_t{1} << slot), std::memory_order_release);
+            }
+        };
+    };
+
+    // --- Epoch-Based Reclamation ---
+    // Readers pin the global epoch for the length of a read-side section (EpochGuard): a store to
+    // their own slot and a fence, nothing shared is written. Writers unlink a node and retire() it;
+    // it is freed once every pinned reader has moved two epochs past the retirement. Threads
+    // without a slot cannot pin and must take the locked path instead; they can still retire.
+    class EpochManager {
+    public:
+        static constexpr uint64_t kIdle = ~uint64_t{0};
+        static constexpr size_t kCollectThreshold = 64;
+
+        static EpochManager& get() { static EpochManager inst; return inst; }
+
+        EpochManager() = default;
+        // At teardown no reader is left, so whatever is still pending can go
+        ~EpochManager() {
+            for (Slot& s : slots_) {
+                for (const Retired& r : s.retired) r.deleter(r.ptr);
+            }
+            for (const Retired& r : orphans_) r.deleter(r.ptr);
+        }
+
+        // Returns false when the calling thread has no slot
+        bool enter() {
+            size_t slot = ThreadSlot::index();
+            if (slot == ThreadSlot::kNoSlot) return false;
+            Slot& s = slots_[slot];
+            if (s.depth++ == 0) {
+                s.epoch.store(global_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+            return true;
+        }
+
+        void exit() {
+            Slot& s = slots_[ThreadSlot::index()];
+            if (--s.depth == 0) s.epoch.store(kIdle, std::memory_order_release);
+        }
+
+        // `ptr` must already be unreachable for new readers
+        void retire(void* ptr, void (*deleter)(void*)) {
+            Retired r{ptr, deleter, global_.load(std::memory_order_acquire)};
+            size_t slot = ThreadSlot::index();
+            if (slot == ThreadSlot::kNoSlot) [[unlikely]] {
+                SpinGuard g(orphan_lock_);
+                orphans_.push_back(r);
+                if (orphans_.size() >= kCollectThreshold) collect(orphans_);
+                return;
+            }
+            Slot& s = slots_[slot];
+            s.retired.push_back(r);
+            if (s.retired.size() >= kCollectThreshold) collect(s.retired);
+        }
+
+    private:
+        struct Retired {
+            void* ptr;
+            void (*deleter)(void*);
+            uint64_t epoch;
+        };
+
+        struct alignas(LEVIATHAN_CACHELINE) Slot {
+            std::atomic<uint64_t> epoch{kIdle};
+            uint32_t depth = 0;            // Nested guards; owner only
+            std::vector<Retired> retired;  // Owner only
+        };
+
+        std::atomic<uint64_t> global_{0};
+        std::array<Slot, LEVIATHAN_MAX_THREADS> slots_;
+        SpinLock orphan_lock_;
+        std::vector<Retired> orphans_; // Retired by threads without a slot
+
+        void collect(std::vector<Retired>& retired) {
+            // Advance when every pinned reader has seen the current epoch
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            uint64_t e = global_.load(std::memory_order_acquire);
+            bool all_current = true;
+            for (const Slot& s : slots_) {
+                uint64_t v = s.epoch.load(std::memory_order_acquire);
+                if (v != kIdle && v != e) { all_current = false; break; }
+            }
+            if (all_current) global_.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel);
+
+            uint64_t now = global_.load(std::memory_order_acquire);
+            std::erase_if(retired, [now](const Retired& r) {
+                if (r.epoch + 2 > now) return false;
+                r.deleter(r.ptr);
+                return true;
+            });
+        }
+    };
+
+    class EpochGuard {
+        bool active_;
+    public:
+        EpochGuard() : active_(EpochManager::get().enter()) {}
+        ~EpochGuard() { if (active_) EpochManager::get().exit(); }
+        EpochGuard(const EpochGuard&) = delete;
+        EpochGuard& operator=(const EpochGuard&) = delete;
+
+        bool active() const { return active_; }
+    };
+
     // --- Math & Crypto Utils ---
     struct Hash256 {
         uint64_t h[4];
@@ -293,297 +440,2414 @@ namespace Leviathan {
 // SECTION 3: MEMORY SUBSYSTEM (SLAB, ARENA, BUDDY)
 // =====================================================================================================================
 
+    // --- Page Source (Anonymous Mappings) ---
+    // Aligned memory straight from the OS. release() drops the physical pages but keeps the range
+    // mapped, so the next touch faults in zeroed pages without another mmap.
+    struct PageSource {
+        static constexpr size_t kHugePage = size_t{2} << 20;
+
+        static void* map(size_t bytes, size_t align, bool huge) {
+            #if defined(__linux__)
+                // Over-reserve by `align`, then trim both ends down to an aligned window
+                size_t reserve = bytes + align;
+                void* raw = ::mmap(nullptr, reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (raw == MAP_FAILED) throw std::bad_alloc();
+                uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+                uintptr_t aligned = (base + align - 1) & ~(uintptr_t{align} - 1);
+                if (aligned > base) ::munmap(raw, aligned - base);
+                if (size_t tail = base + reserve - (aligned + bytes)) ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+                #if defined(MADV_HUGEPAGE)
+                    if (huge) ::madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE);
+                #endif
+                return reinterpret_cast<void*>(aligned);
+            #else
+                (void)huge;
+                return ::operator new(bytes, std::align_val_t(align));
+            #endif
+        }
+
+        static void release(void* ptr, size_t bytes) {
+            #if defined(__linux__)
+                ::madvise(ptr, bytes, MADV_DONTNEED);
+            #else
+                (void)ptr; (void)bytes;
+            #endif
+        }
+
+        static void unmap(void* ptr, size_t bytes, size_t align) {
+            #if defined(__linux__)
+                (void)align;
+                ::munmap(ptr, bytes);
+            #else
+                (void)bytes;
+                ::operator delete(ptr, std::align_val_t(align));
+            #endif
+        }
+    };
+
+    struct SlabStats {
+        size_t objects_used = 0;   // Live objects
+        size_t bytes_used = 0;     // Live objects times their class size
+        size_t spans = 0;          // Spans owned by size classes
+        size_t pages_resident = 0; // Pages touched in those spans (the RSS the slab is responsible for)
+        size_t pages_retained = 0; // Header pages of drained spans parked for reuse
+        size_t spans_released = 0; // Drains handed back to the OS so far
+        double fragmentation = 0;  // 1 - bytes_used / resident bytes
+    };
+
+    // --- Size-Class Slab (Backend) ---
+    // One allocator for every small object size. A request rounds up to one of kNumClasses size
+    // classes; each class carves objects out of spans. Spans are aligned to their own size, so the
+    // span header (and with it the class) is found by masking the pointer. Objects are carved by a
+    // bump index, so a fresh span only faults in the pages actually handed out.
+    //
+    // Each span counts its live objects. The class keeps spans with free slots on a partial list and
+    // one drained span as a resident spare; any further span that drains has everything past its
+    // header page returned to the OS with madvise and is parked on a retained list that every class
+    // can draw from.
+    class SizeClassSlab {
+    public:
+        static constexpr size_t kNumClasses = 28;
+        static constexpr size_t kMaxObject = 4096;
+        static constexpr size_t kSpanSize = 64 * 1024;
+        static constexpr size_t kHeaderBytes = LEVIATHAN_CACHELINE;
+
+        // 16-byte steps to 128, then four classes per power of two up to 4096
+        static constexpr size_t class_size(size_t cls) {
+            if (cls < 8) return (cls + 1) * 16;
+            size_t group = (cls - 8) / 4;
+            return (size_t{128} << group) + ((cls - 8) % 4 + 1) * (size_t{32} << group);
+        }
+
+        static constexpr size_t class_of(size_t bytes) {
+            if (bytes <= 128) return bytes <= 16 ? 0 : (bytes - 1) / 16;
+            size_t group = static_cast<size_t>(std::bit_width((bytes - 1) / 128)) - 1;
+            size_t base = size_t{128} << group;
+            size_t step = size_t{32} << group;
+            return 8 + group * 4 + (bytes - base + step - 1) / step - 1;
+        }
+
+        struct Options {
+            bool huge_pages = false; // 2 MiB spans advised as transparent huge pages
+        };
+
+        static SizeClassSlab& get() { static SizeClassSlab inst; return inst; }
+
+        SizeClassSlab() : SizeClassSlab(Options{}) {}
+        explicit SizeClassSlab(Options opts)
+            : span_bytes_(opts.huge_pages ? PageSource::kHugePage : kSpanSize), huge_(opts.huge_pages) {
+            for (size_t c = 0; c < kNumClasses; ++c) classes_[c].object_size = class_size(c);
+        }
+
+        ~SizeClassSlab() {
+            for (Span* s : all_spans_) PageSource::unmap(s, span_bytes_, span_bytes_);
+        }
+
+        SizeClassSlab(const SizeClassSlab&) = delete;
+        SizeClassSlab& operator=(const SizeClassSlab&) = delete;
+
+        void* allocate(size_t bytes) {
+            LEV_ASSERT(bytes <= kMaxObject, "SizeClassSlab: object larger than the largest class");
+            void* ptr = nullptr;
+            allocate_batch(class_of(bytes), &ptr, 1);
+            return ptr;
+        }
+
+        void deallocate(void* ptr) {
+            if (!ptr) return;
+            deallocate_batch(span_of(ptr)->size_class, &ptr, 1);
+        }
+
+        // Fills out[0..n) from one class under a single lock acquisition
+        void allocate_batch(size_t cls, void** out, size_t n) {
+            ClassState& k = classes_[cls];
+            SpinGuard g(k.lock);
+            for (size_t i = 0; i < n; ++i) {
+                if (!k.partial) add_span_locked(k, cls);
+                Span* s = k.partial;
+                void* obj;
+                if (s->free_list) {
+                    obj = s->free_list;
+                    s->free_list = s->free_list->next;
+                } else {
+                    obj = carve_locked(k, s);
+                }
+                if (++s->used == s->capacity) unlink_locked(k, s);
+                out[i] = obj;
+            }
+            k.used += n;
+        }
+
+        // Returns objects[0..n), all of class `cls`. Spans that drain are released after the lock drops.
+        void deallocate_batch(size_t cls, void* const* objects, size_t n) {
+            ClassState& k = classes_[cls];
+            Span* drained = nullptr;
+            {
+                SpinGuard g(k.lock);
+                for (size_t i = 0; i < n; ++i) {
+                    Span* s = span_of(objects[i]);
+                    LEV_ASSERT(s->size_class == cls, "SizeClassSlab: object freed to the wrong class");
+                    Block* b = static_cast<Block*>(objects[i]);
+                    b->next = s->free_list;
+                    s->free_list = b;
+                    if (s->used-- == s->capacity) link_locked(k, s);
+                    if (s->used == 0) {
+                        unlink_locked(k, s);
+                        if (!k.spare) {
+                            k.spare = s;
+                        } else {
+                            --k.spans;
+                            k.pages -= s->touched_pages;
+                            s->next = drained;
+                            drained = s;
+                        }
+                    }
+                }
+                k.used -= n;
+            }
+            while (drained) {
+                Span* next = drained->next;
+                retire(drained);
+                drained = next;
+            }
+        }
+
+        SlabStats stats(size_t cls) const {
+            SlabStats st;
+            {
+                const ClassState& k = classes_[cls];
+                SpinGuard g(k.lock);
+                st.objects_used = k.used;
+                st.bytes_used = k.used * k.object_size;
+                st.spans = k.spans;
+                st.pages_resident = k.pages;
+            }
+            fill_global(st);
+            return st;
+        }
+
+        SlabStats stats() const {
+            SlabStats st;
+            for (const ClassState& k : classes_) {
+                SpinGuard g(k.lock);
+                st.objects_used += k.used;
+                st.bytes_used += k.used * k.object_size;
+                st.spans += k.spans;
+                st.pages_resident += k.pages;
+            }
+            fill_global(st);
+            return st;
+        }
+
+        size_t span_bytes() const { return span_bytes_; }
+
+    private:
+        struct Block { Block* next; };
+
+        struct Span {
+            uint32_t size_class;
+            uint32_t object_size;
+            uint32_t capacity;
+            uint32_t used;          // Occupancy
+            uint32_t carved;        // Slots handed out at least once; the rest are untouched
+            uint32_t touched_pages; // Pages faulted in by carving, header page included
+            Block* free_list;
+            Span* prev;             // Partial list links; `next` also chains retained spans
+            Span* next;
+            bool listed;
+
+            uint8_t* slots() { return reinterpret_cast<uint8_t*>(this) + kHeaderBytes; }
+        };
+        static_assert(sizeof(Span) <= kHeaderBytes, "span header must fit its reserved line");
+
+        struct alignas(LEVIATHAN_CACHELINE) ClassState {
+            mutable SpinLock lock;
+            size_t object_size = 0;
+            Span* partial = nullptr; // Spans with at least one free slot
+            Span* spare = nullptr;   // One drained span kept resident against alloc/free churn
+            size_t spans = 0;
+            size_t pages = 0;
+            size_t used = 0;
+        };
+
+        const size_t span_bytes_;
+        const bool huge_;
+        std::array<ClassState, kNumClasses> classes_;
+
+        mutable SpinLock span_lock_; // Guards the retained list and the span registry
+        Span* retained_ = nullptr;
+        size_t retained_count_ = 0;
+        size_t released_total_ = 0;
+        std::vector<Span*> all_spans_;
+
+        Span* span_of(void* ptr) const {
+            return reinterpret_cast<Span*>(reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t{span_bytes_} - 1));
+        }
+
+        void* carve_locked(ClassState& k, Span* s) {
+            uint8_t* obj = s->slots() + static_cast<size_t>(s->carved++) * s->object_size;
+            size_t end = kHeaderBytes + static_cast<size_t>(s->carved) * s->object_size;
+            size_t pages = (end + LEVIATHAN_PAGE_SIZE - 1) / LEVIATHAN_PAGE_SIZE;
+            if (pages > s->touched_pages) {
+                k.pages += pages - s->touched_pages;
+                s->touched_pages = static_cast<uint32_t>(pages);
+            }
+            return obj;
+        }
+
+        void add_span_locked(ClassState& k, size_t cls) {
+            Span* s = std::exchange(k.spare, nullptr);
+            if (!s) {
+                s = take_retained();
+                if (!s) s = static_cast<Span*>(map_span());
+                s->size_class = static_cast<uint32_t>(cls);
+                s->object_size = static_cast<uint32_t>(k.object_size);
+                s->capacity = static_cast<uint32_t>((span_bytes_ - kHeaderBytes) / k.object_size);
+                s->used = 0;
+                s->carved = 0;
+                s->touched_pages = 1;
+                s->free_list = nullptr;
+                s->listed = false;
+                ++k.spans;
+                k.pages += 1;
+            }
+            link_locked(k, s);
+        }
+
+        void link_locked(ClassState& k, Span* s) {
+            s->prev = nullptr;
+            s->next = k.partial;
+            if (k.partial) k.partial->prev = s;
+            k.partial = s;
+            s->listed = true;
+        }
+
+        void unlink_locked(ClassState& k, Span* s) {
+            if (!s->listed) return;
+            if (s->prev) s->prev->next = s->next;
+            else k.partial = s->next;
+            if (s->next) s->next->prev = s->prev;
+            s->listed = false;
+        }
+
+        void* map_span() {
+            void* mem = PageSource::map(span_bytes_, span_bytes_, huge_);
+            SpinGuard g(span_lock_);
+            all_spans_.push_back(static_cast<Span*>(mem));
+            return mem;
+        }
+
+        Span* take_retained() {
+            SpinGuard g(span_lock_);
+            Span* s = retained_;
+            if (s) {
+                retained_ = s->next;
+                --retained_count_;
+            }
+            return s;
+        }
+
+        // Everything past the header page goes back to the OS; the header page stays to chain the span
+        void retire(Span* s) {
+            PageSource::release(reinterpret_cast<uint8_t*>(s) + LEVIATHAN_PAGE_SIZE, span_bytes_ - LEVIATHAN_PAGE_SIZE);
+            SpinGuard g(span_lock_);
+            s->next = retained_;
+            retained_ = s;
+            ++retained_count_;
+            ++released_total_;
+        }
+
+        void fill_global(SlabStats& st) const {
+            {
+                SpinGuard g(span_lock_);
+                st.pages_retained = retained_count_;
+                st.spans_released = released_total_;
+            }
+            size_t resident_bytes = st.pages_resident * LEVIATHAN_PAGE_SIZE;
+            st.fragmentation = resident_bytes ? 1.0 - static_cast<double>(st.bytes_used) / static_cast<double>(resident_bytes) : 0.0;
+        }
+    };
+
     // --- Slab Allocator (Fixed Size Objects) ---
-    template <size_t ObjectSize, size_t BlockSize = 4096>
+    // Magazine front end (Bonwick & Adams) over the size-class slab: every thread slot owns a loaded
+    // and a previous magazine, each a small LIFO stack of free objects. The common
+    // allocate/deallocate is a pop or push on memory no other thread touches: no lock, no atomic RMW.
+    // When both magazines are spent the thread trades one whole magazine with the shared depot; only
+    // when the depot has no full magazine does it reach the backend, which fills one under a single
+    // lock acquisition. The depot keeps at most kDepotFullLimit full magazines and flushes the rest
+    // to the backend, so a burst's worth of freed objects can drain their spans.
+    template <size_t ObjectSize>
     class SlabAllocator {
-        struct Block { Block* next; };
-        struct Page {
-            std::unique_ptr<uint8_t[]> memory;
-            Page* next;
-            Page() : memory(std::make_unique<uint8_t[]>(BlockSize)), next(nullptr) {}
+        static_assert(ObjectSize <= SizeClassSlab::kMaxObject, "object larger than the largest size class");
+        static constexpr size_t kClass = SizeClassSlab::class_of(std::max(ObjectSize, sizeof(void*)));
+        static constexpr size_t kMagazineSize = 32;
+        static constexpr size_t kDepotFullLimit = 4;
+
+        struct Magazine {
+            size_t count = 0;
+            void* objects[kMagazineSize];
+        };
+
+        // Invariant outside a call: `previous` is null, empty or full
+        struct alignas(LEVIATHAN_CACHELINE) ThreadCache {
+            Magazine* loaded = nullptr;
+            Magazine* previous = nullptr;
+            std::atomic<int64_t> live{0}; // Allocs minus frees through this slot; owner writes only
         };
 
-        std::atomic<Block*> free_list_{nullptr};
-        SpinLock lock_;
-        std::vector<std::unique_ptr<Page>> pages_;
-        std::atomic<size_t> allocated_objects_{0};
+        SizeClassSlab& backend_;
+        std::atomic<size_t> allocated_objects_{0}; // Through the uncached path
+
+        // Depot
+        SpinLock depot_lock_;
+        std::vector<Magazine*> full_;
+        std::vector<Magazine*> empty_;
+        std::vector<std::unique_ptr<Magazine>> magazines_; // Owns every magazine
+
+        std::array<ThreadCache, LEVIATHAN_MAX_THREADS> caches_;
 
     public:
-        SlabAllocator() { expand(); }
+        SlabAllocator() : SlabAllocator(SizeClassSlab::get()) {}
+        explicit SlabAllocator(SizeClassSlab& backend) : backend_(backend) {}
+
+        // Cached objects go back to the backend; objects still live are the caller's leak
+        ~SlabAllocator() {
+            for (auto& mag : magazines_) flush(*mag);
+        }
+
+        SlabAllocator(const SlabAllocator&) = delete;
+        SlabAllocator& operator=(const SlabAllocator&) = delete;
 
         void* allocate() {
-            SpinGuard g(lock_);
-            if (!free_list_.load(std::memory_order_relaxed)) expand();
-            Block* block = free_list_.load(std::memory_order_relaxed);
-            free_list_.store(block->next, std::memory_order_relaxed);
-            allocated_objects_.fetch_add(1, std::memory_order_relaxed);
-            return block;
+            size_t slot = ThreadSlot::index();
+            if (slot == ThreadSlot::kNoSlot) [[unlikely]] return allocate_uncached();
+
+            ThreadCache& c = caches_[slot];
+            if (!c.loaded || c.loaded->count == 0) [[unlikely]] reload_for_alloc(c);
+            c.live.store(c.live.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return c.loaded->objects[--c.loaded->count];
         }
 
         void deallocate(void* ptr) {
             if (!ptr) return;
-            SpinGuard g(lock_);
-            Block* block = static_cast<Block*>(ptr);
-            block->next = free_list_.load(std::memory_order_relaxed);
-            free_list_.store(block, std::memory_order_relaxed);
+            size_t slot = ThreadSlot::index();
+            if (slot == ThreadSlot::kNoSlot) [[unlikely]] return deallocate_uncached(ptr);
+
+            ThreadCache& c = caches_[slot];
+            if (!c.loaded || c.loaded->count == kMagazineSize) [[unlikely]] reload_for_free(c);
+            c.live.store(c.live.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            c.loaded->objects[c.loaded->count++] = ptr;
+        }
+
+        // Uncached path: straight to the backend, one lock per call. Used by threads without a
+        // slot, and by the benchmark as the baseline.
+        void* allocate_uncached() {
+            void* ptr = nullptr;
+            backend_.allocate_batch(kClass, &ptr, 1);
+            allocated_objects_.fetch_add(1, std::memory_order_relaxed);
+            return ptr;
+        }
+
+        void deallocate_uncached(void* ptr) {
+            if (!ptr) return;
+            backend_.deallocate_batch(kClass, &ptr, 1);
             allocated_objects_.fetch_sub(1, std::memory_order_relaxed);
         }
 
-        size_t stats_used() const { return allocated_objects_.load(); }
-        size_t stats_pages() const { return pages_.size(); }
+        size_t stats_used() const {
+            int64_t live = static_cast<int64_t>(allocated_objects_.load());
+            for (const auto& c : caches_) live += c.live.load(std::memory_order_relaxed);
+            return static_cast<size_t>(std::max<int64_t>(live, 0));
+        }
+        // Resident pages of this object size's class, shared with other allocators of the same class
+        size_t stats_pages() const { return backend_.stats(kClass).pages_resident; }
+        SlabStats stats() const { return backend_.stats(kClass); }
 
     private:
-        void expand() {
-            auto page = std::make_unique<Page>();
-            uint8_t* start = page->memory.get();
-            size_t capacity = BlockSize / ObjectSize;
-            
-            for (size_t i = 0; i < capacity - 1; ++i) {
-                Block* curr = reinterpret_cast<Block*>(start + (i * ObjectSize));
-                Block* next = reinterpret_cast<Block*>(start + ((i + 1) * ObjectSize));
-                curr->next = next;
+        void reload_for_alloc(ThreadCache& c) {
+            if (c.previous && c.previous->count > 0) {
+                std::swap(c.loaded, c.previous);
+                return;
+            }
+            // Hand the empty previous to the depot, take a full one back
+            Magazine* full = exchange_for_full(c.previous);
+            c.previous = c.loaded;
+            c.loaded = full;
+        }
+
+        void reload_for_free(ThreadCache& c) {
+            if (c.previous && c.previous->count == 0) {
+                std::swap(c.loaded, c.previous);
+                return;
+            }
+            Magazine* empty = exchange_for_empty(c.previous);
+            c.previous = c.loaded;
+            c.loaded = empty;
+        }
+
+        Magazine* exchange_for_full(Magazine* empty) {
+            Magazine* mag = nullptr;
+            {
+                SpinGuard g(depot_lock_);
+                if (empty) empty_.push_back(empty);
+                if (!full_.empty()) {
+                    mag = full_.back();
+                    full_.pop_back();
+                    return mag;
+                }
+                mag = take_empty_locked();
             }
-            Block* last = reinterpret_cast<Block*>(start + ((capacity - 1) * ObjectSize));
-            last->next = free_list_.load(std::memory_order_relaxed);
-            free_list_.store(reinterpret_cast<Block*>(start), std::memory_order_relaxed);
-            pages_.push_back(std::move(page));
+            // Depot dry: fill from the backend in one go
+            backend_.allocate_batch(kClass, mag->objects, kMagazineSize);
+            mag->count = kMagazineSize;
+            return mag;
+        }
+
+        Magazine* exchange_for_empty(Magazine* full) {
+            {
+                SpinGuard g(depot_lock_);
+                if (!full || full_.size() < kDepotFullLimit) {
+                    if (full) full_.push_back(full);
+                    return take_empty_locked();
+                }
+            }
+            // Depot at its limit: this magazine's objects go back to their spans instead
+            flush(*full);
+            return full;
+        }
+
+        Magazine* take_empty_locked() {
+            if (!empty_.empty()) {
+                Magazine* mag = empty_.back();
+                empty_.pop_back();
+                return mag;
+            }
+            magazines_.push_back(std::make_unique<Magazine>());
+            return magazines_.back().get();
+        }
+
+        void flush(Magazine& mag) {
+            backend_.deallocate_batch(kClass, mag.objects, mag.count);
+            mag.count = 0;
         }
     };
 
     // --- Arena Allocator (Linear/Region based) ---
-    // Great for per-request allocations that are freed all at once.
-    class ArenaAllocator {
+    // Great for per-request allocations that are freed all at once. An arena has a single owner and
+    // takes no locks: use one per thread (local()) or embed one in the object whose lifetime it
+    // shares. Regions form a chain that is rewound, not freed: reset() and rewind() are O(1), and the
+    // next allocations reuse the regions already in the chain. Small regions come from the
+    // size-class slab, larger ones from the heap. As a std::pmr::memory_resource it backs pmr
+    // containers directly; their deallocations are no-ops until the arena rewinds.
+    class ArenaAllocator : public std::pmr::memory_resource {
+        enum class Source : uint8_t { EXTERNAL, SLAB, HEAP };
+
         struct Region {
-            std::unique_ptr<uint8_t[]> data;
+            Region* next;
             size_t size;
             size_t used;
-            Region* next;
-            Region(size_t s) : data(std::make_unique<uint8_t[]>(s)), size(s), used(0), next(nullptr) {}
+            Source source;
+
+            uint8_t* data() { return reinterpret_cast<uint8_t*>(this) + sizeof(Region); }
+
+            void* try_bump(size_t bytes, size_t align) {
+                uintptr_t base = reinterpret_cast<uintptr_t>(data());
+                uintptr_t ptr = (base + used + align - 1) & ~(uintptr_t{align} - 1);
+                if (ptr + bytes > base + size) return nullptr;
+                used = ptr + bytes - base;
+                return reinterpret_cast<void*>(ptr);
+            }
         };
-        
+
         Region* head_;
         Region* current_;
         size_t default_size_;
-        SpinLock lock_;
 
     public:
+        struct Mark {
+            Region* region;
+            size_t used;
+        };
+
         explicit ArenaAllocator(size_t block_size = 65536) : default_size_(block_size) {
-            head_ = new Region(default_size_);
+            head_ = make_region(default_size_);
             current_ = head_;
         }
 
-        ~ArenaAllocator() {
-            reset();
-            delete head_; 
+        // First region is the caller's buffer (e.g. inline in the owning object); overflow chains regions of block_size
+        ArenaAllocator(void* buffer, size_t bytes, size_t block_size) : default_size_(block_size) {
+            LEV_ASSERT(bytes > sizeof(Region), "ArenaAllocator: initial buffer smaller than a region header");
+            head_ = ::new (buffer) Region{nullptr, bytes - sizeof(Region), 0, Source::EXTERNAL};
+            current_ = head_;
         }
 
-        void* alloc(size_t bytes, size_t align = 8) {
-            SpinGuard g(lock_);
-            size_t padding = (align - (reinterpret_cast<uintptr_t>(current_->data.get()) + current_->used) % align) % align;
-            if (current_->used + bytes + padding > current_->size) {
-                // Allocate new region
-                size_t new_size = std::max(default_size_, bytes + align);
-                Region* new_reg = new Region(new_size);
-                current_->next = new_reg;
-                current_ = new_reg;
-                padding = 0; // New buffer is aligned
+        ~ArenaAllocator() override {
+            Region* r = head_;
+            while (r) {
+                Region* next = r->next;
+                free_region(r);
+                r = next;
             }
-            
-            void* ptr = current_->data.get() + current_->used + padding;
-            current_->used += bytes + padding;
-            return ptr;
         }
 
-        void reset() {
-            SpinGuard g(lock_);
-            Region* curr = head_;
-            while(curr) {
-                curr->used = 0;
-                Region* next = curr->next;
-                if (curr != head_) delete curr; // Keep head, delete others
-                else curr->next = nullptr;
-                curr = next;
+        ArenaAllocator(const ArenaAllocator&) = delete;
+        ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+        // Per-thread arena for request-scoped scratch; pair with ArenaScope
+        static ArenaAllocator& local() {
+            thread_local ArenaAllocator arena;
+            return arena;
+        }
+
+        void* alloc(size_t bytes, size_t align = alignof(std::max_align_t)) {
+            if (void* ptr = current_->try_bump(bytes, align)) [[likely]] return ptr;
+            return alloc_slow(bytes, align);
+        }
+
+        Mark mark() const { return {current_, current_->used}; }
+
+        // Frees everything allocated since `m`; regions past it stay chained for reuse
+        void rewind(Mark m) {
+            current_ = m.region;
+            current_->used = m.used;
+        }
+
+        void reset() { rewind({head_, 0}); }
+
+        // Returns regions past the current one to their source
+        void release_unused() {
+            Region* r = std::exchange(current_->next, nullptr);
+            while (r) {
+                Region* next = r->next;
+                free_region(r);
+                r = next;
+            }
+        }
+
+        size_t bytes_reserved() const {
+            size_t total = 0;
+            for (Region* r = head_; r; r = r->next) total += r->size;
+            return total;
+        }
+
+    private:
+        void* do_allocate(size_t bytes, size_t align) override { return alloc(bytes, align); }
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        void* alloc_slow(size_t bytes, size_t align) {
+            // Regions are rewound lazily: a chained region is emptied when the bump pointer reaches it
+            Region* next = current_->next;
+            if (next && next->size >= bytes + align) {
+                next->used = 0;
+            } else {
+                next = make_region(std::max(default_size_, bytes + align));
+                next->next = current_->next;
+                current_->next = next;
+            }
+            current_ = next;
+            return current_->try_bump(bytes, align);
+        }
+
+        static Region* make_region(size_t size) {
+            size_t total = sizeof(Region) + size;
+            bool slab = total <= SizeClassSlab::kMaxObject;
+            void* mem = slab ? SizeClassSlab::get().allocate(total) : ::operator new(total);
+            return ::new (mem) Region{nullptr, size, 0, slab ? Source::SLAB : Source::HEAP};
+        }
+
+        static void free_region(Region* r) {
+            switch (r->source) {
+                case Source::EXTERNAL: break;
+                case Source::SLAB: SizeClassSlab::get().deallocate(r); break;
+                case Source::HEAP: ::operator delete(r); break;
             }
-            current_ = head_;
         }
     };
 
-// =====================================================================================================================
-// SECTION 4: SOFTWARE TRANSACTIONAL MEMORY (STM) - MVCC
-// =====================================================================================================================
+    // Rewinds an arena to where it stood at construction
+    class ArenaScope {
+        ArenaAllocator& arena_;
+        ArenaAllocator::Mark mark_;
 
-    struct STMTransaction {
-        uint64_t id;
-        uint64_t start_ts;
-        bool active;
-        std::unordered_set<void*> read_set;
-        std::unordered_map<void*, std::vector<uint8_t>> write_set;
+    public:
+        ArenaScope() : ArenaScope(ArenaAllocator::local()) {}
+        explicit ArenaScope(ArenaAllocator& arena) : arena_(arena), mark_(arena.mark()) {}
+        ~ArenaScope() { arena_.rewind(mark_); }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+        std::pmr::memory_resource* resource() { return &arena_; }
     };
 
-    class STMManager {
-        std::atomic<uint64_t> global_clock_{0};
-        std::shared_mutex lock_table_mutex_;
-        std::unordered_map<void*, std::shared_mutex> row_locks_;
+    struct BuddyStats {
+        size_t bytes_total = 0;
+        size_t bytes_allocated = 0;        // Block bytes handed out
+        size_t bytes_requested = 0;        // What callers asked for
+        size_t bytes_free = 0;
+        size_t largest_free = 0;           // Largest block allocatable right now
+        std::vector<size_t> free_blocks;   // Free blocks per order
+        double internal_fragmentation = 0; // 1 - requested / allocated
+        double external_fragmentation = 0; // 1 - largest_free / min(bytes_free, max block)
+    };
 
+    // --- Buddy Allocator (Power-of-Two Blocks) ---
+    // Variable-size blocks of kMinBlock << order from one mmap'd region, each aligned to its size.
+    // Every order has its own lock, an intrusive free list, and a bitmap with one bit per buddy pair
+    // holding free(A) xor free(B). Freeing a block whose pair bit drops to zero means the buddy is
+    // free too, so the two merge and the check repeats one order up; allocation takes the smallest
+    // order with a free block and splits down, freeing the upper halves. No call holds more than one
+    // order's lock at a time, so a block in the middle of a merge can make a concurrent alloc report
+    // exhaustion early. As a memory_resource it falls back to `upstream` for requests above the
+    // largest block and when the region is exhausted.
+    class BuddyAllocator : public std::pmr::memory_resource {
     public:
-        static STMManager& get() { static STMManager inst; return inst; }
+        static constexpr size_t kMinBlock = 64;
+
+        explicit BuddyAllocator(size_t region_bytes = size_t{64} << 20, size_t max_block = size_t{4} << 20,
+                                std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+            : max_block_(std::bit_ceil(std::max(max_block, kMinBlock))),
+              max_order_(static_cast<size_t>(std::countr_zero(max_block_ / kMinBlock))),
+              region_bytes_(std::max(region_bytes / max_block_, size_t{1}) * max_block_),
+              upstream_(upstream)
+        {
+            LEV_ASSERT(max_block_ < (size_t{1} << (32 - kOrderBits)), "BuddyAllocator: max block too large for block metadata");
+            base_ = static_cast<uint8_t*>(PageSource::map(region_bytes_, max_block_, false));
+            meta_ = std::make_unique<uint32_t[]>(region_bytes_ / kMinBlock);
+            orders_ = std::make_unique<OrderState[]>(max_order_ + 1);
+            for (size_t o = 0; o < max_order_; ++o) {
+                size_t pairs = region_bytes_ / (kMinBlock << o) / 2;
+                orders_[o].pair_bits.assign((pairs + 63) / 64, 0);
+            }
+            for (size_t off = 0; off < region_bytes_; off += max_block_) push_locked(max_order_, base_ + off);
+        }
+
+        ~BuddyAllocator() override { PageSource::unmap(base_, region_bytes_, max_block_); }
+
+        BuddyAllocator(const BuddyAllocator&) = delete;
+        BuddyAllocator& operator=(const BuddyAllocator&) = delete;
+
+        // Shared pool for file data and packet buffers
+        static BuddyAllocator& get() { static BuddyAllocator inst; return inst; }
+
+        // Smallest block holding `bytes`, or nullptr when none is free
+        void* alloc(size_t bytes) {
+            if (bytes > max_block_) return nullptr;
+            size_t order = order_for(bytes);
+            for (size_t o = order; o <= max_order_; ++o) {
+                uint8_t* block;
+                {
+                    SpinGuard g(orders_[o].lock);
+                    block = pop_locked(o);
+                    if (block) toggle_locked(o, block);
+                }
+                if (!block) continue;
+
+                for (size_t s = o; s-- > order;) {
+                    uint8_t* upper = block + (kMinBlock << s);
+                    SpinGuard g(orders_[s].lock);
+                    push_locked(s, upper);
+                    toggle_locked(s, upper);
+                }
+                meta_[unit_of(block)] = static_cast<uint32_t>(bytes << kOrderBits | order);
+                bytes_allocated_.fetch_add(kMinBlock << order, std::memory_order_relaxed);
+                bytes_requested_.fetch_add(bytes, std::memory_order_relaxed);
+                return block;
+            }
+            return nullptr;
+        }
+
+        void dealloc(void* ptr) {
+            if (!ptr) return;
+            uint8_t* block = static_cast<uint8_t*>(ptr);
+            LEV_ASSERT(owns(block), "BuddyAllocator: pointer outside the region");
+            uint32_t meta = meta_[unit_of(block)];
+            size_t order = meta & kOrderMask;
+            bytes_allocated_.fetch_sub(kMinBlock << order, std::memory_order_relaxed);
+            bytes_requested_.fetch_sub(meta >> kOrderBits, std::memory_order_relaxed);
+
+            for (size_t o = order;; ++o) {
+                SpinGuard g(orders_[o].lock);
+                if (toggle_locked(o, block)) {
+                    push_locked(o, block);
+                    return;
+                }
+                // Pair bit fell to zero: the buddy is on this order's free list
+                uint8_t* buddy = base_ + (static_cast<size_t>(block - base_) ^ (kMinBlock << o));
+                unlink_locked(o, buddy);
+                block = std::min(block, buddy);
+            }
+        }
+
+        bool owns(const void* ptr) const {
+            auto p = static_cast<const uint8_t*>(ptr);
+            return p >= base_ && p < base_ + region_bytes_;
+        }
+
+        size_t block_size(const void* ptr) const {
+            return kMinBlock << (meta_[unit_of(static_cast<const uint8_t*>(ptr))] & kOrderMask);
+        }
+
+        BuddyStats stats() const {
+            BuddyStats st;
+            st.bytes_total = region_bytes_;
+            st.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+            st.bytes_requested = bytes_requested_.load(std::memory_order_relaxed);
+            st.free_blocks.resize(max_order_ + 1);
+            for (size_t o = 0; o <= max_order_; ++o) {
+                SpinGuard g(orders_[o].lock);
+                st.free_blocks[o] = orders_[o].free_count;
+                st.bytes_free += orders_[o].free_count * (kMinBlock << o);
+                if (orders_[o].free_count) st.largest_free = kMinBlock << o;
+            }
+            if (st.bytes_allocated) st.internal_fragmentation = 1.0 - static_cast<double>(st.bytes_requested) / static_cast<double>(st.bytes_allocated);
+            if (st.bytes_free) {
+                size_t best = std::min(st.bytes_free, max_block_);
+                st.external_fragmentation = 1.0 - static_cast<double>(st.largest_free) / static_cast<double>(best);
+            }
+            return st;
+        }
+
+    private:
+        static constexpr uint32_t kOrderBits = 5;
+        static constexpr uint32_t kOrderMask = (1u << kOrderBits) - 1;
+
+        struct FreeBlock {
+            FreeBlock* prev;
+            FreeBlock* next;
+        };
+
+        struct OrderState {
+            mutable SpinLock lock;
+            FreeBlock* head = nullptr;
+            size_t free_count = 0;
+            std::vector<uint64_t> pair_bits; // One bit per buddy pair; the top order has none
+        };
+
+        const size_t max_block_;
+        const size_t max_order_;
+        const size_t region_bytes_;
+        std::pmr::memory_resource* upstream_;
+        uint8_t* base_ = nullptr;
+        std::unique_ptr<uint32_t[]> meta_; // Per min block: requested bytes << kOrderBits | order, set on the first unit
+        std::unique_ptr<OrderState[]> orders_;
+        std::atomic<size_t> bytes_allocated_{0};
+        std::atomic<size_t> bytes_requested_{0};
+
+        static size_t order_for(size_t bytes) {
+            return static_cast<size_t>(std::countr_zero(std::bit_ceil(std::max(bytes, kMinBlock)) / kMinBlock));
+        }
+
+        size_t unit_of(const uint8_t* block) const { return static_cast<size_t>(block - base_) / kMinBlock; }
+
+        // Flips the block's pair bit; true when the pair must not merge (bit now set, or top order)
+        bool toggle_locked(size_t order, const uint8_t* block) {
+            if (order == max_order_) return true;
+            size_t pair = static_cast<size_t>(block - base_) / (kMinBlock << order) / 2;
+            uint64_t& word = orders_[order].pair_bits[pair / 64];
+            word ^= uint64_t{1} << (pair % 64);
+            return (word >> (pair % 64)) & 1;
+        }
+
+        void push_locked(size_t order, uint8_t* block) {
+            OrderState& os = orders_[order];
+            auto* b = reinterpret_cast<FreeBlock*>(block);
+            b->prev = nullptr;
+            b->next = os.head;
+            if (os.head) os.head->prev = b;
+            os.head = b;
+            ++os.free_count;
+        }
+
+        uint8_t* pop_locked(size_t order) {
+            OrderState& os = orders_[order];
+            FreeBlock* b = os.head;
+            if (!b) return nullptr;
+            os.head = b->next;
+            if (os.head) os.head->prev = nullptr;
+            --os.free_count;
+            return reinterpret_cast<uint8_t*>(b);
+        }
+
+        void unlink_locked(size_t order, uint8_t* block) {
+            OrderState& os = orders_[order];
+            auto* b = reinterpret_cast<FreeBlock*>(block);
+            if (b->prev) b->prev->next = b->next;
+            else os.head = b->next;
+            if (b->next) b->next->prev = b->prev;
+            --os.free_count;
+        }
+
+        void* do_allocate(size_t bytes, size_t align) override {
+            if (void* ptr = alloc(std::max(bytes, align))) return ptr;
+            return upstream_->allocate(bytes, align);
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t align) override {
+            if (owns(ptr)) dealloc(ptr);
+            else upstream_->deallocate(ptr, bytes, align);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+// =====================================================================================================================
+// SECTION 4: SOFTWARE TRANSACTIONAL MEMORY (STM) - TL2
+// =====================================================================================================================
+
+    // Copies between shared memory and a private buffer without a C++ data race: aligned whole
+    // words go through relaxed atomic_ref, the rest byte by byte. Callers order them with fences.
+    inline void shared_load(void* dst, const void* src, size_t n) {
+        auto* s = const_cast<uint8_t*>(static_cast<const uint8_t*>(src));
+        auto* d = static_cast<uint8_t*>(dst);
+        size_t i = 0;
+        if (reinterpret_cast<uintptr_t>(s) % alignof(uint64_t) == 0) {
+            for (; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+                uint64_t w = std::atomic_ref<uint64_t>(*reinterpret_cast<uint64_t*>(s + i)).load(std::memory_order_relaxed);
+                std::memcpy(d + i, &w, sizeof(w));
+            }
+        }
+        for (; i < n; ++i) d[i] = std::atomic_ref<uint8_t>(s[i]).load(std::memory_order_relaxed);
+    }
+
+    inline void shared_store(void* dst, const void* src, size_t n) {
+        auto* d = static_cast<uint8_t*>(dst);
+        auto* s = static_cast<const uint8_t*>(src);
+        size_t i = 0;
+        if (reinterpret_cast<uintptr_t>(d) % alignof(uint64_t) == 0) {
+            for (; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+                uint64_t w;
+                std::memcpy(&w, s + i, sizeof(w));
+                std::atomic_ref<uint64_t>(*reinterpret_cast<uint64_t*>(d + i)).store(w, std::memory_order_relaxed);
+            }
+        }
+        for (; i < n; ++i) std::atomic_ref<uint8_t>(d[i]).store(s[i], std::memory_order_relaxed);
+    }
+
+    // Thrown from a transactional read that saw a newer or locked location; atomically() retries
+    struct STMAbort {};
+
+    class STMManager;
+
+    // One attempt's bookkeeping. Locations are trivially copyable objects, always accessed with the
+    // same type. Read and write sets are fixed-capacity open-addressing tables, so a transaction
+    // allocates nothing; exceeding them is a kernel panic, not a silent fallback.
+    struct STMTransaction {
+        static constexpr size_t kMaxReads = 1024;
+        static constexpr size_t kMaxWrites = 128;
+        static constexpr size_t kWriteBytes = 4096;
+
+        // Distinct lock stripes read so far
+        struct ReadSet {
+            static constexpr size_t kSlots = kMaxReads * 2;
+            std::array<uint32_t, kSlots> slots{};  // Stripe + 1; 0 = empty
+            std::array<uint32_t, kMaxReads> used;  // Occupied slot positions, for iteration and clear
+            size_t count = 0;
+
+            bool insert(uint32_t stripe) {
+                size_t pos = (stripe * 0x9E3779B1u) % kSlots;
+                while (slots[pos]) {
+                    if (slots[pos] == stripe + 1) return true;
+                    pos = (pos + 1) % kSlots;
+                }
+                if (count == kMaxReads) return false;
+                slots[pos] = stripe + 1;
+                used[count++] = static_cast<uint32_t>(pos);
+                return true;
+            }
+
+            uint32_t stripe(size_t i) const { return slots[used[i]] - 1; }
+
+            void clear() {
+                for (size_t i = 0; i < count; ++i) slots[used[i]] = 0;
+                count = 0;
+            }
+        };
+
+        // Buffered writes keyed by address; values live in a bump buffer until commit
+        struct WriteSet {
+            struct Entry {
+                void* addr;
+                uint32_t size;
+                uint32_t offset;
+            };
+            static constexpr size_t kSlots = kMaxWrites * 2;
+            std::array<uint16_t, kSlots> slots{}; // Entry index + 1; 0 = empty
+            std::array<Entry, kMaxWrites> entries;
+            size_t count = 0;
+            alignas(uint64_t) std::array<uint8_t, kWriteBytes> bytes;
+            size_t bytes_used = 0;
+
+            static size_t hash(const void* addr) {
+                return static_cast<size_t>((reinterpret_cast<uintptr_t>(addr) >> 3) * 0x9E3779B97F4A7C15ull >> 32) % kSlots;
+            }
+
+            Entry* find(const void* addr) {
+                for (size_t pos = hash(addr); slots[pos]; pos = (pos + 1) % kSlots) {
+                    if (entries[slots[pos] - 1].addr == addr) return &entries[slots[pos] - 1];
+                }
+                return nullptr;
+            }
+
+            Entry* insert(void* addr, size_t size) {
+                size_t pos = hash(addr);
+                for (; slots[pos]; pos = (pos + 1) % kSlots) {
+                    if (entries[slots[pos] - 1].addr == addr) return &entries[slots[pos] - 1];
+                }
+                size_t offset = (bytes_used + alignof(uint64_t) - 1) & ~(alignof(uint64_t) - 1);
+                if (count == kMaxWrites || offset + size > kWriteBytes) return nullptr;
+                entries[count] = {addr, static_cast<uint32_t>(size), static_cast<uint32_t>(offset)};
+                slots[pos] = static_cast<uint16_t>(++count);
+                bytes_used = offset + size;
+                return &entries[count - 1];
+            }
+
+            void clear() {
+                for (size_t i = 0; i < count; ++i) {
+                    for (size_t pos = hash(entries[i].addr);; pos = (pos + 1) % kSlots) {
+                        if (slots[pos] == i + 1) { slots[pos] = 0; break; }
+                    }
+                }
+                count = 0;
+                bytes_used = 0;
+            }
+        };
+
+        uint64_t id = 0;
+        uint64_t start_ts = 0; // Read version: every location read must be no newer than this
+        bool active = false;
+        ReadSet read_set;
+        WriteSet write_set;
+        STMManager* mgr = nullptr;
+
+        template <typename T> T read(const T& loc);
+        template <typename T> void write(T& loc, const T& value);
+    };
+
+    struct STMStats {
+        uint64_t commits = 0;
+        uint64_t aborts = 0;
+    };
+
+    // TL2 (Dice, Shalev & Shavit): a global version clock plus a striped table of versioned locks
+    // (version << 1 | locked). Reads are validated as they happen against the transaction's read
+    // version, so a running transaction never sees an inconsistent snapshot. Commit locks the write
+    // stripes, takes a write version from the clock, re-validates the read set unless nothing else
+    // committed in between, writes back and releases the stripes at the new version. A failed
+    // attempt retries with randomized exponential backoff.
+    class STMManager {
+    public:
+        static constexpr size_t kStripeBits = 16;
+        static constexpr size_t kStripes = size_t{1} << kStripeBits;
+
+        static STMManager& get() { static STMManager inst; return inst; }
+
+        STMManager() : locks_(std::make_unique<std::atomic<uint64_t>[]>(kStripes)) {}
+
+        // Runs body(tx) until it commits and returns its result. A nested call joins the
+        // enclosing transaction. Exceptions other than STMAbort discard the attempt and propagate.
+        template <typename F>
+        auto atomically(F&& body) -> std::invoke_result_t<F&, STMTransaction&> {
+            using R = std::invoke_result_t<F&, STMTransaction&>;
+            STMTransaction& tx = local_tx();
+            if (tx.active) return body(tx);
+
+            for (uint32_t attempt = 0;; ++attempt) {
+                begin_tx(tx);
+                try {
+                    if constexpr (std::is_void_v<R>) {
+                        body(tx);
+                        if (validate_and_commit(tx)) return;
+                    } else {
+                        R result = body(tx);
+                        if (validate_and_commit(tx)) return result;
+                    }
+                } catch (const STMAbort&) {
+                    end_tx(tx);
+                } catch (...) {
+                    end_tx(tx);
+                    throw;
+                }
+                slot_stats().aborts.fetch_add(1, std::memory_order_relaxed);
+                backoff(attempt);
+            }
+        }
+
+        void begin_tx(STMTransaction& tx) {
+            tx.mgr = this;
+            tx.id++;
+            tx.start_ts = global_clock_.load(std::memory_order_acquire);
+            tx.active = true;
+        }
+
+        bool validate_and_commit(STMTransaction& tx) {
+            if (tx.write_set.count == 0) {
+                // Read-only: every read was already checked against start_ts
+                end_tx(tx);
+                slot_stats().commits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            // 1. Lock the write stripes. Never wait on a held stripe: abort and let backoff sort it out
+            std::array<uint32_t, STMTransaction::kMaxWrites> held;
+            std::array<uint64_t, STMTransaction::kMaxWrites> held_versions;
+            size_t held_count = 0;
+            auto holds = [&](uint32_t stripe) {
+                return std::find(held.begin(), held.begin() + held_count, stripe) != held.begin() + held_count;
+            };
+            auto release_held = [&] {
+                for (size_t i = 0; i < held_count; ++i) locks_[held[i]].store(held_versions[i], std::memory_order_release);
+            };
+
+            for (size_t i = 0; i < tx.write_set.count; ++i) {
+                uint32_t stripe = stripe_of(tx.write_set.entries[i].addr);
+                if (holds(stripe)) continue;
+                uint64_t v = locks_[stripe].load(std::memory_order_relaxed);
+                if ((v & 1) || !locks_[stripe].compare_exchange_strong(v, v | 1, std::memory_order_acquire)) {
+                    release_held();
+                    end_tx(tx);
+                    return false;
+                }
+                held[held_count] = stripe;
+                held_versions[held_count++] = v;
+            }
+
+            // 2. Write version. If nobody committed since we began, the read set cannot be stale
+            uint64_t wv = global_clock_.fetch_add(1, std::memory_order_acq_rel) + 1;
+            if (wv != tx.start_ts + 1) {
+                for (size_t i = 0; i < tx.read_set.count; ++i) {
+                    uint32_t stripe = tx.read_set.stripe(i);
+                    uint64_t v = locks_[stripe].load(std::memory_order_acquire);
+                    if (v & 1) {
+                        // Locked: fine only if it is ours, judged by the version it had before we locked it
+                        auto it = std::find(held.begin(), held.begin() + held_count, stripe);
+                        v = it == held.begin() + held_count ? v : held_versions[it - held.begin()];
+                    }
+                    if ((v & 1) || (v >> 1) > tx.start_ts) {
+                        release_held();
+                        end_tx(tx);
+                        return false;
+                    }
+                }
+            }
+
+            // 3. Write back, then publish the stripes at the new version
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < tx.write_set.count; ++i) {
+                const auto& e = tx.write_set.entries[i];
+                shared_store(e.addr, tx.write_set.bytes.data() + e.offset, e.size);
+            }
+            for (size_t i = 0; i < held_count; ++i) locks_[held[i]].store(wv << 1, std::memory_order_release);
+
+            end_tx(tx);
+            slot_stats().commits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        STMStats stats() const {
+            STMStats st;
+            for (const auto& s : stats_) {
+                st.commits += s.commits.load(std::memory_order_relaxed);
+                st.aborts += s.aborts.load(std::memory_order_relaxed);
+            }
+            return st;
+        }
+
+        uint32_t stripe_of(const void* addr) const {
+            return static_cast<uint32_t>((reinterpret_cast<uintptr_t>(addr) >> 3) * 0x9E3779B97F4A7C15ull >> (64 - kStripeBits));
+        }
+
+        std::atomic<uint64_t>& lock_at(uint32_t stripe) { return locks_[stripe]; }
+
+    private:
+        struct alignas(LEVIATHAN_CACHELINE) SlotStats {
+            std::atomic<uint64_t> commits{0};
+            std::atomic<uint64_t> aborts{0};
+        };
+
+        std::atomic<uint64_t> global_clock_{0};
+        std::unique_ptr<std::atomic<uint64_t>[]> locks_;
+        std::array<SlotStats, LEVIATHAN_MAX_THREADS + 1> stats_; // Last entry shared by slotless threads
+
+        SlotStats& slot_stats() { return stats_[ThreadSlot::index()]; }
+
+        // One per thread, shared by every atomically() instantiation so nesting is detected
+        static STMTransaction& local_tx() {
+            thread_local STMTransaction tx;
+            return tx;
+        }
+
+        static void end_tx(STMTransaction& tx) {
+            tx.read_set.clear();
+            tx.write_set.clear();
+            tx.active = false;
+        }
+
+        static void backoff(uint32_t attempt) {
+            if (attempt >= 16) {
+                std::this_thread::yield();
+                return;
+            }
+            uint64_t spins = XorShift64::next() % (uint64_t{16} << std::min<uint32_t>(attempt, 10));
+            for (uint64_t i = 0; i < spins; ++i) std::atomic_signal_fence(std::memory_order_seq_cst);
+        }
+    };
+
+    template <typename T>
+    T STMTransaction::read(const T& loc) {
+        static_assert(std::is_trivially_copyable_v<T>, "transactional locations must be trivially copyable");
+        alignas(T) std::array<std::byte, sizeof(T)> value; // No default constructor needed
+        if (const auto* e = write_set.find(&loc)) {
+            std::memcpy(value.data(), write_set.bytes.data() + e->offset, sizeof(T));
+            return std::bit_cast<T>(value);
+        }
+
+        // Seqlock-style sample: lock word, value, lock word again
+        uint32_t stripe = mgr->stripe_of(&loc);
+        std::atomic<uint64_t>& lock = mgr->lock_at(stripe);
+        uint64_t v1 = lock.load(std::memory_order_acquire);
+        shared_load(value.data(), &loc, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t v2 = lock.load(std::memory_order_relaxed);
+        if ((v1 & 1) || v1 != v2 || (v1 >> 1) > start_ts) throw STMAbort{};
+
+        LEV_ASSERT(read_set.insert(stripe), "STM: transaction exceeded its read set");
+        return std::bit_cast<T>(value);
+    }
+
+    template <typename T>
+    void STMTransaction::write(T& loc, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "transactional locations must be trivially copyable");
+        auto* e = write_set.insert(&loc, sizeof(T));
+        LEV_ASSERT(e != nullptr, "STM: transaction exceeded its write set");
+        LEV_ASSERT(e->size == sizeof(T), "STM: location written with two different types");
+        std::memcpy(write_set.bytes.data() + e->offset, &value, sizeof(T));
+    }
+
+    // Writes are exclusive. For trivially copyable T, read() is optimistic: a seqlock sample
+    // (sequence, value, sequence again) that writes no shared memory and retries only when it
+    // overlapped a write. A reader that keeps losing to writers falls back to the shared lock.
+    template<typename T>
+    class TVar { // Transactional Variable
+        static constexpr bool kOptimistic = std::is_trivially_copyable_v<T>;
+        static constexpr int kOptimisticTries = 64;
+
+        T value_;
+        std::atomic<uint64_t> seq_{0}; // Odd while a write is in progress
+        mutable std::shared_mutex mutex_;
+    public:
+        TVar(T v) : value_(v) {}
+        
+        T read() const {
+            if constexpr (kOptimistic) {
+                for (int i = 0; i < kOptimisticTries; ++i) {
+                    uint64_t before = seq_.load(std::memory_order_acquire);
+                    if (before & 1) continue;
+                    // Sampled as raw bytes: T need not be default constructible, and a torn sample is
+                    // never turned into a T
+                    alignas(T) std::array<std::byte, sizeof(T)> bytes;
+                    shared_load(bytes.data(), &value_, sizeof(T));
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (seq_.load(std::memory_order_relaxed) == before) return std::bit_cast<T>(bytes);
+                }
+            }
+            std::shared_lock lock(mutex_);
+            return value_;
+        }
+        
+        void write(const T& val) {
+            std::unique_lock lock(mutex_);
+            if constexpr (kOptimistic) {
+                uint64_t seq = seq_.load(std::memory_order_relaxed);
+                seq_.store(seq + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                shared_store(&value_, &val, sizeof(T));
+                seq_.store(seq + 2, std::memory_order_release);
+            } else {
+                value_ = val;
+            }
+        }
+    };
+
+// =====================================================================================================================
+// SECTION 5: VFS (VIRTUAL FILE SYSTEM)
+// =====================================================================================================================
+
+    enum class FileType { REGULAR, DIRECTORY, DEVICE };
+
+    // --- File Extents ---
+    // File contents are an immutable snapshot of extent references, swapped whole on every write.
+    // Extents are refcounted runs of bytes shared between snapshots, so a write copies only the
+    // bytes it writes plus the reference list, and readers pin a snapshot instead of copying data.
+    // Bytes [0, filled) of an extent never change; an append may fill the tail in place, since no
+    // snapshot refers past `filled`.
+    struct Extent {
+        static constexpr size_t kMinCapacity = 256;
+        static constexpr size_t kMaxCapacity = 64 * 1024;
+
+        std::pmr::memory_resource* mr;
+        uint8_t* bytes;
+        uint32_t capacity;
+        uint32_t filled = 0;
+
+        Extent(std::pmr::memory_resource* r, size_t cap)
+            : mr(r), bytes(static_cast<uint8_t*>(r->allocate(cap, alignof(std::max_align_t)))), capacity(static_cast<uint32_t>(cap)) {}
+        ~Extent() { mr->deallocate(bytes, capacity, alignof(std::max_align_t)); }
+
+        Extent(const Extent&) = delete;
+        Extent& operator=(const Extent&) = delete;
+    };
+
+    struct ExtentRef {
+        std::shared_ptr<Extent> extent;
+        uint32_t offset;      // Into the extent
+        uint32_t length;
+        uint64_t file_offset; // Where this run starts in the file
+    };
+
+    struct FileExtents {
+        std::pmr::vector<ExtentRef> refs; // Sorted and contiguous by file_offset
+        uint64_t size = 0;
+
+        explicit FileExtents(std::pmr::memory_resource* mr) : refs(mr) {}
+
+        // Index of the ref holding byte `off` (refs.size() at or past EOF)
+        size_t locate(uint64_t off) const {
+            if (off >= size) return refs.size();
+            auto it = std::upper_bound(refs.begin(), refs.end(), off,
+                                       [](uint64_t o, const ExtentRef& r) { return o < r.file_offset; });
+            return static_cast<size_t>(it - refs.begin()) - 1;
+        }
+    };
+
+    // Read-only view of a byte range. The spans point into extents pinned by the view and stay valid
+    // for its lifetime, whatever writes happen meanwhile.
+    class FileView {
+        std::shared_ptr<const FileExtents> pin_;
+        std::vector<std::span<const uint8_t>> spans_;
+        size_t size_ = 0;
+
+    public:
+        FileView() = default;
+        FileView(std::shared_ptr<const FileExtents> pin, uint64_t offset, uint64_t len) : pin_(std::move(pin)) {
+            if (!pin_ || offset >= pin_->size) return;
+            uint64_t end = offset + std::min(len, pin_->size - offset);
+            for (size_t i = pin_->locate(offset); i < pin_->refs.size() && pin_->refs[i].file_offset < end; ++i) {
+                const ExtentRef& r = pin_->refs[i];
+                uint64_t from = std::max(offset, r.file_offset);
+                uint64_t to = std::min(end, r.file_offset + r.length);
+                spans_.emplace_back(r.extent->bytes + r.offset + (from - r.file_offset), to - from);
+                size_ += to - from;
+            }
+        }
+
+        std::span<const std::span<const uint8_t>> spans() const { return spans_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        std::string to_string() const {
+            std::string out;
+            out.reserve(size_);
+            for (auto s : spans_) out.append(reinterpret_cast<const char*>(s.data()), s.size());
+            return out;
+        }
+    };
+
+    struct Inode {
+        uint64_t id;
+        FileType type;
+        std::atomic<size_t> size;
+        uint32_t permissions;
+        TimePoint mtime;
+        std::shared_ptr<const FileExtents> contents; // For regular files; replaced whole by writers
+        std::map<std::string, std::shared_ptr<Inode>, std::less<>> children; // For directories
+        SpinLock lock;          // Children, and serializes writers of `contents`
+        SpinLock contents_lock; // Held only to copy or swap the `contents` pointer
+        uint32_t disk_ino = 0;          // Slot in the persistent image; 0 for memory-only inodes
+        std::atomic<bool> loaded{true}; // False until children (directories) or contents (files) are read from the image
+
+        Inode(uint64_t i, FileType t) : id(i), type(t), size(0), permissions(0777), mtime(Clock::now()) {}
+
+        std::shared_ptr<const FileExtents> snapshot() {
+            SpinGuard g(contents_lock);
+            return contents;
+        }
+    };
+
+    // --- Dentry Cache ---
+    // Hashed (parent inode, name) -> inode, including negative entries for names that do not exist.
+    // Readers walk bucket chains with acquire loads under an EpochGuard: no locks, no refcounts.
+    // Writers hold the parent directory's lock (so an insert cannot race a create in that directory)
+    // and a bucket stripe lock; replaced and evicted entries are retired through the epoch manager.
+    // Chains are capped at kMaxChain, evicting the oldest entry.
+    class DentryCache {
+    public:
+        struct Dentry {
+            uint64_t parent;
+            uint64_t hash;
+            std::string name;
+            std::shared_ptr<Inode> inode; // Null for a negative entry; pins the inode while cached
+            std::atomic<Dentry*> next{nullptr};
+        };
+
+        static constexpr size_t kBuckets = 4096;
+        static constexpr size_t kLockStripes = 64;
+        static constexpr size_t kMaxChain = 8;
+
+        DentryCache() = default;
+        ~DentryCache() {
+            for (auto& head : heads_) {
+                Dentry* d = head.load(std::memory_order_relaxed);
+                while (d) {
+                    Dentry* next = d->next.load(std::memory_order_relaxed);
+                    delete d;
+                    d = next;
+                }
+            }
+        }
+
+        DentryCache(const DentryCache&) = delete;
+        DentryCache& operator=(const DentryCache&) = delete;
+
+        // Null on a miss. The entry stays valid while the caller's EpochGuard is held.
+        const Dentry* find(uint64_t parent, std::string_view name) const {
+            uint64_t h = hash_of(parent, name);
+            for (Dentry* d = heads_[h % kBuckets].load(std::memory_order_acquire); d; d = d->next.load(std::memory_order_acquire)) {
+                if (d->hash == h && d->parent == parent && d->name == name) return d;
+            }
+            return nullptr;
+        }
+
+        // Inserts or replaces. Caller holds the parent directory's lock.
+        void insert(uint64_t parent, std::string_view name, std::shared_ptr<Inode> inode) {
+            uint64_t h = hash_of(parent, name);
+            size_t b = h % kBuckets;
+            auto* fresh = new Dentry{parent, h, std::string(name), std::move(inode)};
+
+            SpinGuard g(locks_[b % kLockStripes]);
+            std::atomic<Dentry*>* link = &heads_[b];
+            for (Dentry* d = link->load(std::memory_order_relaxed); d; d = link->load(std::memory_order_relaxed)) {
+                if (d->hash == h && d->parent == parent && d->name == name) {
+                    link->store(d->next.load(std::memory_order_relaxed), std::memory_order_release);
+                    --lengths_[b];
+                    retire(d);
+                    break;
+                }
+                link = &d->next;
+            }
+
+            fresh->next.store(heads_[b].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            heads_[b].store(fresh, std::memory_order_release);
+            if (++lengths_[b] <= kMaxChain) return;
+
+            // Evict the tail, the oldest entry in the chain
+            std::atomic<Dentry*>* tail_link = &heads_[b];
+            while (Dentry* d = tail_link->load(std::memory_order_relaxed)) {
+                if (!d->next.load(std::memory_order_relaxed)) {
+                    tail_link->store(nullptr, std::memory_order_release);
+                    --lengths_[b];
+                    retire(d);
+                    break;
+                }
+                tail_link = &d->next;
+            }
+        }
+
+    private:
+        std::array<std::atomic<Dentry*>, kBuckets> heads_{};
+        std::array<SpinLock, kLockStripes> locks_;
+        std::array<uint8_t, kBuckets> lengths_{}; // Guarded by the bucket's stripe lock
+
+        static uint64_t hash_of(uint64_t parent, std::string_view name) {
+            return std::hash<std::string_view>{}(name) ^ (parent * 0x9E3779B97F4A7C15ull);
+        }
+
+        static void retire(Dentry* d) {
+            EpochManager::get().retire(d, [](void* p) { delete static_cast<Dentry*>(p); });
+        }
+    };
+
+    struct VfsImageStats {
+        uint32_t blocks_total = 0;
+        uint32_t blocks_free = 0;
+        uint32_t inodes_total = 0;
+        uint32_t inodes_free = 0;
+        uint64_t commits = 0;
+        uint64_t journal_blocks = 0; // Metadata blocks logged, over all commits
+        uint64_t copied_blocks = 0;  // Data blocks copied so an overwrite leaves committed data intact
+        bool replayed = false;       // Mount found a committed transaction and applied it
+        double mount_ms = 0;
+    };
+
+    // --- Persistent Image ---
+    // A tree stored in one file of 4 KiB blocks: superblock, free-block bitmap, inode table (64 B
+    // slots, slot 1 is the root), journal, then data. File data and directories both live in up to
+    // kDirectExtents runs of blocks; a directory is an array of 64 B entries. The file is mmap'd, so
+    // mounting reads the superblock and the journal header and nothing else: inodes, directories
+    // and data fault in as the tree is walked.
+    //
+    // Metadata blocks (superblock, bitmap, inodes, directory blocks) change only through the
+    // write-ahead journal: a transaction collects shadow copies, logs them with a checksum, writes
+    // the commit flag, then copies them home. Mount replays a committed log and ignores a torn one.
+    // File data is written before the log, and only where committed metadata does not point: past
+    // EOF, or into fresh blocks. So appends write just the new bytes, and an overwrite moves just
+    // the blocks it touches to fresh ones, journaling the inode's new extent list. With only
+    // kDirectExtents runs per inode, an overwrite that would split the file into more runs copies
+    // the whole file into one fresh run instead, which also defragments it.
+    class VfsImage {
+    public:
+        static constexpr uint32_t kBlockSize = 4096;
+        static constexpr uint32_t kRootIno = 1;
+        static constexpr size_t kMaxName = 56;
+        static constexpr size_t kDirectExtents = 5;
+
+        struct Options {
+            uint32_t blocks = 4096;        // Image size when formatting (16 MiB)
+            uint32_t inodes = 8192;
+            uint32_t journal_blocks = 16;
+            bool sync = true;              // msync at each journal step; without it only process crashes are covered
+        };
+
+        struct DiskExtent {
+            uint32_t start;
+            uint32_t blocks;
+        };
+
+        struct DiskInode {
+            uint16_t type;         // 0 when free, else FileType + 1
+            uint16_t extent_count;
+            uint32_t permissions;
+            uint64_t size;         // Bytes; for directories, entries * sizeof(DiskDirent)
+            int64_t mtime_ns;      // Wall clock
+            DiskExtent extents[kDirectExtents];
+        };
+        static_assert(sizeof(DiskInode) == 64);
+
+        struct DiskDirent {
+            uint32_t ino;
+            uint8_t name_len;
+            uint8_t type;
+            uint16_t reserved;
+            char name[kMaxName];
+        };
+        static_assert(sizeof(DiskDirent) == 64);
+
+        // Mounts the image at `path`, formatting it first when the file is new or empty, or when a
+        // format of it was cut short. Null if the file cannot be mapped or holds something else.
+        static std::unique_ptr<VfsImage> open(const std::filesystem::path& path) { return open(path, Options{}); }
+
+        static std::unique_ptr<VfsImage> open(const std::filesystem::path& path, Options opts) {
+            #if defined(__linux__)
+                auto t0 = Clock::now();
+                int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+                bool created = fd >= 0;
+                if (!created && errno == EEXIST) fd = ::open(path.c_str(), O_RDWR);
+                if (fd < 0) {
+                    LOG_ERR("[IMG] Cannot open {}: {}", path.string(), std::strerror(errno));
+                    return nullptr;
+                }
+                struct stat st {};
+                ::fstat(fd, &st);
+                size_t bytes = static_cast<size_t>(st.st_size);
+                uint64_t magic = 0;
+                if (bytes >= sizeof(magic) && ::pread(fd, &magic, sizeof(magic), 0) != sizeof(magic)) magic = 0;
+
+                // Only a file this call created, an empty one, or one whose format was cut short is
+                // formatted. The marker is on disk before the file grows, so a crash at any point
+                // of a format leaves it behind; a zeroed or foreign file is refused, not wiped.
+                bool fresh = created || bytes == 0 || magic == kFormatMagic;
+                if (fresh) {
+                    bytes = size_t{opts.blocks} * kBlockSize;
+                    if (::pwrite(fd, &kFormatMagic, sizeof(kFormatMagic), 0) != sizeof(kFormatMagic) ||
+                        (opts.sync && ::fsync(fd) != 0) || ::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                        LOG_ERR("[IMG] Cannot size {}: {}", path.string(), std::strerror(errno));
+                        ::close(fd);
+                        return nullptr;
+                    }
+                }
+                void* base = bytes >= kBlockSize ? ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+                if (base == MAP_FAILED) {
+                    LOG_ERR("[IMG] Cannot map {}", path.string());
+                    ::close(fd);
+                    return nullptr;
+                }
+
+                std::unique_ptr<VfsImage> img(new VfsImage(fd, static_cast<uint8_t*>(base), bytes, opts.sync));
+                if (fresh) {
+                    if (!img->format(opts)) return nullptr;
+                } else if (!img->valid()) {
+                    LOG_ERR("[IMG] {} is not a Leviathan image; leaving it unformatted", path.string());
+                    return nullptr;
+                }
+                img->replay();
+                img->stats_.mount_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+                return img;
+            #else
+                (void)path; (void)opts;
+                return nullptr;
+            #endif
+        }
+
+        ~VfsImage() {
+            #if defined(__linux__)
+                if (sync_) ::msync(base_, bytes_, MS_SYNC);
+                ::munmap(base_, bytes_);
+                ::close(fd_);
+            #endif
+        }
+
+        VfsImage(const VfsImage&) = delete;
+        VfsImage& operator=(const VfsImage&) = delete;
+
+        // Calls f(name, ino, inode) for each entry of directory `dir`
+        template <typename F>
+        void for_each_entry(uint32_t dir, F&& f) {
+            std::lock_guard g(mutex_);
+            const DiskInode& d = committed(dir);
+            for_each_run(d, 0, d.size, [&](uint64_t at, uint64_t len) {
+                const auto* entries = reinterpret_cast<const DiskDirent*>(base_ + at);
+                for (size_t i = 0; i < len / sizeof(DiskDirent); ++i) {
+                    if (entries[i].ino == 0) continue;
+                    f(std::string_view(entries[i].name, entries[i].name_len), entries[i].ino, committed(entries[i].ino));
+                }
+            });
+        }
+
+        // Calls emit(bytes) for each run of the file's data, in order
+        template <typename F>
+        void read(uint32_t ino, F&& emit) {
+            std::lock_guard g(mutex_);
+            const DiskInode& n = committed(ino);
+            for_each_run(n, 0, n.size, [&](uint64_t at, uint64_t len) { emit(std::span<const uint8_t>(base_ + at, len)); });
+        }
+
+        // New inode linked into `parent` as `name`; 0 when the name is too long or the image is full
+        uint32_t create(uint32_t parent, std::string_view name, FileType type, std::span<const uint8_t> content = {}) {
+            if (name.empty() || name.size() > kMaxName) return 0;
+            std::lock_guard g(mutex_);
+            Txn tx(*this);
+            uint32_t ino = alloc_inode(tx);
+            if (!ino) return 0;
+            DiskInode& n = inode(tx, ino);
+            n = DiskInode{};
+            n.type = static_cast<uint16_t>(static_cast<int>(type) + 1);
+            n.permissions = 0777;
+            n.mtime_ns = wall_now();
+            if (!content.empty()) {
+                if (!grow(tx, n, content.size())) return 0;
+                write_data(tx, n, 0, content.size(), content.data());
+                n.size = content.size();
+            }
+            if (!link(tx, parent, name, ino, type)) return 0;
+            return commit(tx) ? ino : 0;
+        }
+
+        // Writes [offset, offset + data.size()); a gap past EOF is zero-filled
+        bool write(uint32_t ino, uint64_t offset, std::span<const uint8_t> data) {
+            std::lock_guard g(mutex_);
+            return write_locked(ino, offset, data);
+        }
+
+        bool append(uint32_t ino, std::span<const uint8_t> data) {
+            std::lock_guard g(mutex_);
+            return write_locked(ino, committed(ino).size, data);
+        }
+
+        VfsImageStats stats() {
+            std::lock_guard g(mutex_);
+            VfsImageStats st = stats_;
+            const Superblock& s = super();
+            st.blocks_total = s.total_blocks;
+            st.blocks_free = s.free_blocks;
+            st.inodes_total = s.inode_count;
+            st.inodes_free = s.free_inodes;
+            return st;
+        }
+
+    private:
+        static constexpr uint64_t kMagic = 0x313053465656454CULL;   // "LEVVFS01"
+        static constexpr uint64_t kFormatMagic = 0x303053465656454CULL; // "LEVVFS00": format in progress
+        static constexpr uint64_t kJournalMagic = 0x4C4E524A56454CULL; // "LEVJRNL"
+        static constexpr uint32_t kVersion = 1;
+        static constexpr uint32_t kInodesPerBlock = kBlockSize / sizeof(DiskInode);
+        static constexpr uint32_t kBitsPerBlock = kBlockSize * 8;
+
+        struct Superblock {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t block_size;
+            uint32_t total_blocks;
+            uint32_t inode_count;
+            uint32_t bitmap_start, bitmap_blocks;
+            uint32_t inode_start, inode_blocks;
+            uint32_t journal_start, journal_blocks;
+            uint32_t data_start;
+            uint32_t free_blocks;
+            uint32_t free_inodes;
+            uint32_t block_hint; // Where the next run search starts
+            uint32_t inode_hint;
+            uint32_t reserved;
+            uint64_t sequence;   // Last committed transaction
+        };
+
+        // First journal block; the logged block images follow it
+        struct JournalHeader {
+            static constexpr size_t kMaxTargets = (kBlockSize - 32) / sizeof(uint32_t);
+
+            uint64_t magic;
+            uint64_t sequence;
+            uint64_t checksum;  // Over the sequence, targets and logged blocks
+            uint32_t count;
+            uint32_t committed; // Set once the log is durable, cleared once it is applied
+            uint32_t targets[kMaxTargets];
+        };
+        static_assert(sizeof(JournalHeader) == kBlockSize);
+
+        // Shadow copies of the metadata blocks a transaction changes; reads go through it so the
+        // transaction sees its own writes. `data` records in-place data writes to flush before the
+        // commit. Dropping a Txn without commit() abandons the whole update.
+        struct Txn {
+            VfsImage& img;
+            std::map<uint32_t, std::unique_ptr<uint8_t[]>> blocks;
+            std::vector<std::pair<uint64_t, uint64_t>> data;
+
+            explicit Txn(VfsImage& i) : img(i) {}
+
+            uint8_t* block(uint32_t b) {
+                auto [it, fresh] = blocks.try_emplace(b);
+                if (fresh) {
+                    it->second = std::make_unique_for_overwrite<uint8_t[]>(kBlockSize);
+                    std::memcpy(it->second.get(), img.block_ptr(b), kBlockSize);
+                }
+                return it->second.get();
+            }
+
+            const uint8_t* view(uint32_t b) const {
+                auto it = blocks.find(b);
+                return it != blocks.end() ? it->second.get() : img.block_ptr(b);
+            }
+        };
+
+        int fd_;
+        uint8_t* base_;
+        size_t bytes_;
+        bool sync_;
+        std::mutex mutex_; // One transaction at a time; reads take it too, as checkpoints rewrite whole blocks
+        VfsImageStats stats_;
+
+        VfsImage(int fd, uint8_t* base, size_t bytes, bool sync) : fd_(fd), base_(base), bytes_(bytes), sync_(sync) {}
+
+        uint8_t* block_ptr(uint32_t b) const { return base_ + size_t{b} * kBlockSize; }
+        const Superblock& super() const { return *reinterpret_cast<const Superblock*>(base_); }
+        Superblock& super(Txn& tx) { return *reinterpret_cast<Superblock*>(tx.block(0)); }
+        JournalHeader& journal() { return *reinterpret_cast<JournalHeader*>(block_ptr(super().journal_start)); }
+
+        static int64_t wall_now() {
+            return std::chrono::duration_cast<Nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        void flush(const void* ptr, size_t len) {
+            #if defined(__linux__)
+                if (!sync_) return;
+                uintptr_t from = reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t{LEVIATHAN_PAGE_SIZE - 1};
+                ::msync(reinterpret_cast<void*>(from), reinterpret_cast<uintptr_t>(ptr) + len - from, MS_SYNC);
+            #else
+                (void)ptr; (void)len;
+            #endif
+        }
+
+        bool valid() const {
+            const Superblock& s = super();
+            return s.magic == kMagic && s.version == kVersion && s.block_size == kBlockSize &&
+                   size_t{s.total_blocks} * kBlockSize == bytes_ && s.data_start < s.total_blocks &&
+                   size_t{s.bitmap_blocks} * kBitsPerBlock >= s.total_blocks &&
+                   s.journal_start + s.journal_blocks == s.data_start && s.journal_blocks > 1 &&
+                   size_t{s.inode_blocks} * kInodesPerBlock >= s.inode_count;
+        }
+
+        // Lays out an empty tree. The first word keeps the in-progress marker open() wrote until
+        // the real magic goes in last, so a crash here leaves a file that is formatted again on
+        // the next mount.
+        bool format(const Options& opts) {
+            Superblock s{};
+            s.magic = kFormatMagic;
+            s.version = kVersion;
+            s.block_size = kBlockSize;
+            s.total_blocks = static_cast<uint32_t>(bytes_ / kBlockSize);
+            s.inode_count = std::max(opts.inodes, kRootIno + 1);
+            s.bitmap_start = 1;
+            s.bitmap_blocks = (s.total_blocks + kBitsPerBlock - 1) / kBitsPerBlock;
+            s.inode_start = s.bitmap_start + s.bitmap_blocks;
+            s.inode_blocks = (s.inode_count + kInodesPerBlock - 1) / kInodesPerBlock;
+            s.journal_start = s.inode_start + s.inode_blocks;
+            s.journal_blocks = std::clamp<uint32_t>(opts.journal_blocks, 2, JournalHeader::kMaxTargets + 1);
+            s.data_start = s.journal_start + s.journal_blocks;
+            if (s.data_start >= s.total_blocks) {
+                LOG_ERR("[IMG] {} blocks cannot hold {} inodes", s.total_blocks, s.inode_count);
+                return false;
+            }
+            s.free_blocks = s.total_blocks - s.data_start;
+            s.free_inodes = s.inode_count - kRootIno - 1; // Slot 0 is never used
+            s.block_hint = s.data_start;
+            s.inode_hint = kRootIno + 1;
+
+            std::memset(base_ + sizeof(s.magic), 0, size_t{s.data_start} * kBlockSize - sizeof(s.magic));
+            for (uint32_t b = 0; b < s.data_start; ++b) block_ptr(s.bitmap_start + b / kBitsPerBlock)[b % kBitsPerBlock / 8] |= uint8_t(1u << (b % 8));
+            auto* root = reinterpret_cast<DiskInode*>(block_ptr(s.inode_start)) + kRootIno;
+            root->type = static_cast<uint16_t>(static_cast<int>(FileType::DIRECTORY) + 1);
+            root->permissions = 0777;
+            root->mtime_ns = wall_now();
+            std::memcpy(base_, &s, sizeof(s));
+            flush(base_, size_t{s.data_start} * kBlockSize);
+
+            reinterpret_cast<Superblock*>(base_)->magic = kMagic;
+            flush(base_, kBlockSize);
+            LOG_INFO("[IMG] Formatted {} blocks, {} inodes", s.total_blocks, s.inode_count);
+            return true;
+        }
+
+        bool write_locked(uint32_t ino, uint64_t offset, std::span<const uint8_t> data) {
+            uint64_t size = committed(ino).size;
+            uint64_t end = offset + data.size();
+            if (data.empty() && offset <= size) return true;
+
+            // Past EOF nothing committed refers to the bytes, so they are written in place; below
+            // it the touched blocks move first. Either may run out of extents, and the retry moves
+            // the whole file instead. The blocks a remap replaced stay allocated until the data is
+            // written: committed metadata still points at them, so grow() must not hand them out.
+            for (bool whole : {false, true}) {
+                Txn tx(*this);
+                DiskInode& n = inode(tx, ino);
+                std::vector<DiskExtent> replaced;
+                bool placed = whole            ? relocate(tx, n, std::max(size, end))
+                              : offset >= size ? grow(tx, n, end)
+                                               : remap(tx, n, offset, std::min(size, end), replaced) && grow(tx, n, end);
+                if (!placed) continue;
+                if (offset > size) write_data(tx, n, size, offset - size, nullptr);
+                write_data(tx, n, offset, data.size(), data.data());
+                for (DiskExtent run : replaced) mark(tx, run, false);
+                n.size = std::max(size, end);
+                n.mtime_ns = wall_now();
+                return commit(tx);
+            }
+            return false;
+        }
+
+        uint64_t checksum(const JournalHeader& h) const {
+            uint64_t sum = IntegrityEngine::fast_hash(h.targets, h.count * sizeof(uint32_t)) ^ h.sequence;
+            for (uint32_t i = 0; i < h.count; ++i) {
+                sum = sum * 0x9E3779B97F4A7C15ULL ^ IntegrityEngine::fast_hash(block_ptr(super().journal_start + 1 + i), kBlockSize);
+            }
+            return sum;
+        }
+
+        void replay() {
+            JournalHeader& h = journal();
+            if (!h.committed) return;
+            bool intact = h.magic == kJournalMagic && h.count < super().journal_blocks && h.checksum == checksum(h) &&
+                          std::all_of(h.targets, h.targets + h.count, [&](uint32_t t) { return t < super().total_blocks; });
+            if (!intact) {
+                LOG_WARN("[IMG] Discarding torn journal transaction {}", h.sequence);
+            } else {
+                for (uint32_t i = 0; i < h.count; ++i) {
+                    std::memcpy(block_ptr(h.targets[i]), block_ptr(super().journal_start + 1 + i), kBlockSize);
+                    flush(block_ptr(h.targets[i]), kBlockSize);
+                }
+                stats_.replayed = true;
+                LOG_WARN("[IMG] Replayed journal transaction {} ({} blocks)", h.sequence, h.count);
+            }
+            h.committed = 0;
+            flush(&h, kBlockSize);
+        }
+
+        bool commit(Txn& tx) {
+            uint32_t journal_start = super().journal_start;
+            super(tx).sequence++;
+            if (tx.blocks.size() >= super().journal_blocks) {
+                LOG_WARN("[IMG] Transaction of {} blocks exceeds the journal", tx.blocks.size());
+                return false;
+            }
+
+            // 1. In-place data, then the log
+            for (auto [at, len] : tx.data) flush(base_ + at, len);
+            JournalHeader& h = journal();
+            uint32_t i = 0;
+            for (const auto& [target, copy] : tx.blocks) {
+                std::memcpy(block_ptr(journal_start + 1 + i), copy.get(), kBlockSize);
+                h.targets[i++] = target;
+            }
+            h.magic = kJournalMagic;
+            h.count = i;
+            h.sequence = super(tx).sequence;
+            h.checksum = checksum(h);
+            flush(&h, size_t{i + 1} * kBlockSize);
+
+            // 2. Commit record
+            h.committed = 1;
+            flush(&h, kBlockSize);
+
+            // 3. Checkpoint
+            for (const auto& [target, copy] : tx.blocks) {
+                std::memcpy(block_ptr(target), copy.get(), kBlockSize);
+                flush(block_ptr(target), kBlockSize);
+            }
+            h.committed = 0;
+            flush(&h, kBlockSize);
+
+            stats_.commits++;
+            stats_.journal_blocks += i;
+            return true;
+        }
+
+        const DiskInode& committed(uint32_t ino) const {
+            return reinterpret_cast<const DiskInode*>(block_ptr(super().inode_start + ino / kInodesPerBlock))[ino % kInodesPerBlock];
+        }
+
+        DiskInode& inode(Txn& tx, uint32_t ino) {
+            return reinterpret_cast<DiskInode*>(tx.block(super().inode_start + ino / kInodesPerBlock))[ino % kInodesPerBlock];
+        }
+
+        const DiskInode& peek(const Txn& tx, uint32_t ino) const {
+            return reinterpret_cast<const DiskInode*>(tx.view(super().inode_start + ino / kInodesPerBlock))[ino % kInodesPerBlock];
+        }
+
+        uint32_t alloc_inode(Txn& tx) {
+            const Superblock& s = super();
+            if (!s.free_inodes) return 0;
+            for (uint32_t i = 0, ino = s.inode_hint; i < s.inode_count; ++i, ino = ino + 1 < s.inode_count ? ino + 1 : kRootIno + 1) {
+                if (peek(tx, ino).type) continue;
+                Superblock& ws = super(tx);
+                ws.free_inodes--;
+                ws.inode_hint = ino + 1 < s.inode_count ? ino + 1 : kRootIno + 1;
+                return ino;
+            }
+            return 0;
+        }
+
+        bool used(const Txn& tx, uint32_t b) const {
+            return tx.view(super().bitmap_start + b / kBitsPerBlock)[b % kBitsPerBlock / 8] >> (b % 8) & 1;
+        }
+
+        void mark(Txn& tx, DiskExtent run, bool in_use) {
+            for (uint32_t b = run.start; b < run.start + run.blocks; ++b) {
+                uint8_t& byte = tx.block(super().bitmap_start + b / kBitsPerBlock)[b % kBitsPerBlock / 8];
+                byte = in_use ? byte | uint8_t(1u << (b % 8)) : byte & uint8_t(~(1u << (b % 8)));
+            }
+            Superblock& s = super(tx);
+            s.free_blocks = in_use ? s.free_blocks - run.blocks : s.free_blocks + run.blocks;
+        }
+
+        uint32_t free_run_at(const Txn& tx, uint32_t start, uint64_t max) const {
+            uint32_t n = 0;
+            while (n < max && start + n < super().total_blocks && !used(tx, start + n)) ++n;
+            return n;
+        }
 
-        uint64_t begin_tx() { return global_clock_.load(std::memory_order_acquire); }
+        // First run of `want` free blocks from the hint on, else the longest one seen
+        DiskExtent find_run(Txn& tx, uint64_t want) {
+            const Superblock& s = super();
+            uint32_t span = s.total_blocks - s.data_start;
+            DiskExtent best{0, 0};
+            for (uint32_t i = 0; i < span;) {
+                uint32_t b = s.data_start + (s.block_hint - s.data_start + i) % span;
+                uint32_t run = used(tx, b) ? 0 : free_run_at(tx, b, want);
+                if (run > best.blocks) best = {b, run};
+                if (run == want) break;
+                i += std::max(run, 1u);
+            }
+            if (best.blocks) super(tx).block_hint = best.start + best.blocks < s.total_blocks ? best.start + best.blocks : s.data_start;
+            return best;
+        }
 
-        bool validate_and_commit(STMTransaction& tx) {
-            // Simplified validation: Lock all write set addresses
-            // In a real MVCC, we would check version numbers.
-            std::vector<std::unique_lock<std::shared_mutex>> locks;
-            
-            // 1. Acquire Locks (Order by address to prevent deadlock)
-            std::vector<void*> sorted_keys;
-            for(auto& [ptr, _] : tx.write_set) sorted_keys.push_back(ptr);
-            std::sort(sorted_keys.begin(), sorted_keys.end());
+        static uint64_t blocks_of(const DiskInode& n) {
+            uint64_t total = 0;
+            for (size_t i = 0; i < n.extent_count; ++i) total += n.extents[i].blocks;
+            return total;
+        }
 
-            {
-                std::unique_lock table_lock(lock_table_mutex_);
-                for(void* ptr : sorted_keys) {
-                    if(!row_locks_.contains(ptr)) row_locks_[ptr]; // Create mutex if not exists
+        // Gives `n` room for `bytes`, extending its last run in place where possible. On failure
+        // `n` and the bitmap are left as they were.
+        bool grow(Txn& tx, DiskInode& n, uint64_t bytes) {
+            uint64_t need = (bytes + kBlockSize - 1) / kBlockSize;
+            uint64_t have = blocks_of(n);
+            if (have >= need) return true;
+
+            DiskInode next = n;
+            std::vector<DiskExtent> taken;
+            auto take = [&](DiskExtent run) {
+                mark(tx, run, true);
+                taken.push_back(run);
+                have += run.blocks;
+                DiskExtent* last = next.extent_count ? &next.extents[next.extent_count - 1] : nullptr;
+                if (last && last->start + last->blocks == run.start) last->blocks += run.blocks;
+                else next.extents[next.extent_count++] = run;
+            };
+
+            if (next.extent_count) {
+                const DiskExtent& last = next.extents[next.extent_count - 1];
+                if (uint32_t run = free_run_at(tx, last.start + last.blocks, need - have)) take({last.start + last.blocks, run});
+            }
+            while (have < need) {
+                DiskExtent run = next.extent_count < kDirectExtents ? find_run(tx, need - have) : DiskExtent{0, 0};
+                if (!run.blocks) {
+                    for (DiskExtent t : taken) mark(tx, t, false);
+                    return false;
                 }
+                take(run);
+            }
+            n = next;
+            return true;
+        }
+
+        // Moves `n` into fresh blocks with room for `bytes`, copying its current data, and frees the old ones
+        bool relocate(Txn& tx, DiskInode& n, uint64_t bytes) {
+            DiskInode old = n;
+            n.extent_count = 0;
+            if (!grow(tx, n, bytes)) {
+                n = old;
+                return false;
             }
+            for_each_run(old, 0, old.size, [&, pos = uint64_t{0}](uint64_t at, uint64_t len) mutable {
+                write_data(tx, n, pos, len, base_ + at);
+                pos += len;
+            });
+            stats_.copied_blocks += (old.size + kBlockSize - 1) / kBlockSize;
+            for (size_t i = 0; i < old.extent_count; ++i) mark(tx, old.extents[i], false);
+            return true;
+        }
 
-            for(void* ptr : sorted_keys) {
-                // Unsafe here in this simplified snippet due to map rehashing risk if we didn't hold table lock
-                // but for simulation we assume fixed pointers.
-                // We re-acquire shared lock on table to get reference safely? No, simple map access for now.
-                // NOTE: This is a simulation of the complexity.
+        // Points the blocks holding bytes [from, to) of `n` at fresh blocks, and appends the old
+        // runs to `replaced` for the caller to free once nothing else will be allocated in `tx`.
+        // The first and last of them are copied over, as the write may cover them only in part.
+        // False, leaving `n` and the bitmap as they were, when space runs out or the new layout
+        // needs more than kDirectExtents runs.
+        bool remap(Txn& tx, DiskInode& n, uint64_t from, uint64_t to, std::vector<DiskExtent>& replaced) {
+            uint64_t first = from / kBlockSize, last = (to - 1) / kBlockSize;
+            std::vector<DiskExtent> before, old, after, fresh;
+            uint64_t logical = 0;
+            for (size_t i = 0; i < n.extent_count; ++i) {
+                DiskExtent e = n.extents[i];
+                uint64_t lo = logical, hi = logical + e.blocks;
+                auto piece = [&](std::vector<DiskExtent>& out, uint64_t a, uint64_t b) {
+                    if (a < b) out.push_back({static_cast<uint32_t>(e.start + (a - lo)), static_cast<uint32_t>(b - a)});
+                };
+                piece(before, lo, std::min(hi, first));
+                piece(old, std::max(lo, first), std::min(hi, last + 1));
+                piece(after, std::max(lo, last + 1), hi);
+                logical = hi;
             }
-            
-            // 2. Commit Memory
-            for(auto& [ptr, data] : tx.write_set) {
-                std::memcpy(ptr, data.data(), data.size());
+
+            DiskInode next = n;
+            next.extent_count = 0;
+            auto place = [&](DiskExtent run) {
+                DiskExtent* tail = next.extent_count ? &next.extents[next.extent_count - 1] : nullptr;
+                if (tail && tail->start + tail->blocks == run.start) tail->blocks += run.blocks;
+                else if (next.extent_count < kDirectExtents) next.extents[next.extent_count++] = run;
+                else return false;
+                return true;
+            };
+            auto undo = [&] {
+                for (DiskExtent t : fresh) mark(tx, t, false);
+                return false;
+            };
+
+            bool fits = std::all_of(before.begin(), before.end(), place);
+            for (uint64_t got = 0; fits && got < last - first + 1;) {
+                DiskExtent run = find_run(tx, last - first + 1 - got);
+                if (!run.blocks) return undo();
+                mark(tx, run, true);
+                fresh.push_back(run);
+                got += run.blocks;
+                fits = place(run);
             }
+            if (!fits || !std::all_of(after.begin(), after.end(), place)) return undo();
 
-            global_clock_.fetch_add(1);
+            auto carry = [&](uint64_t b) {
+                if (from <= b * kBlockSize && to >= (b + 1) * kBlockSize) return; // Fully overwritten
+                for_each_run(n, b * kBlockSize, kBlockSize, [&](uint64_t src, uint64_t) {
+                    write_data(tx, next, b * kBlockSize, kBlockSize, base_ + src);
+                });
+                stats_.copied_blocks++;
+            };
+            carry(first);
+            if (last != first) carry(last);
+            replaced.insert(replaced.end(), old.begin(), old.end());
+            n = next;
             return true;
         }
-    };
 
-    template<typename T>
-    class TVar { // Transactional Variable
-        T value_;
-        mutable std::shared_mutex mutex_;
-    public:
-        TVar(T v) : value_(v) {}
-        
-        T read() const {
-            std::shared_lock lock(mutex_);
-            return value_;
-        }
-        
-        void write(const T& val) {
-            std::unique_lock lock(mutex_);
-            value_ = val;
+        // Calls f(image byte offset, length) for each contiguous piece of [pos, pos + len) of `n`
+        template <typename F>
+        static void for_each_run(const DiskInode& n, uint64_t pos, uint64_t len, F&& f) {
+            uint64_t logical = 0;
+            for (size_t i = 0; i < n.extent_count && len; ++i) {
+                uint64_t run_bytes = uint64_t{n.extents[i].blocks} * kBlockSize;
+                if (pos < logical + run_bytes) {
+                    uint64_t skip = pos - logical;
+                    uint64_t take = std::min(len, run_bytes - skip);
+                    f(uint64_t{n.extents[i].start} * kBlockSize + skip, take);
+                    pos += take;
+                    len -= take;
+                }
+                logical += run_bytes;
+            }
         }
-    };
-
-// =====================================================================================================================
-// SECTION 5: VFS (VIRTUAL FILE SYSTEM)
-// =====================================================================================================================
-
-    enum class FileType { REGULAR, DIRECTORY, DEVICE };
 
-    struct Inode {
-        uint64_t id;
-        FileType type;
-        size_t size;
-        uint32_t permissions;
-        TimePoint mtime;
-        std::vector<uint8_t> data; // For regular files
-        std::map<std::string, std::shared_ptr<Inode>> children; // For directories
-        SpinLock lock;
+        // Data bytes go straight to the image (zeros when `src` is null); only for bytes no
+        // committed metadata refers to
+        void write_data(Txn& tx, const DiskInode& n, uint64_t pos, uint64_t len, const uint8_t* src) {
+            for_each_run(n, pos, len, [&](uint64_t at, uint64_t run) {
+                if (src) {
+                    std::memcpy(base_ + at, src, run);
+                    src += run;
+                } else {
+                    std::memset(base_ + at, 0, run);
+                }
+                tx.data.emplace_back(at, run);
+            });
+        }
 
-        Inode(uint64_t i, FileType t) : id(i), type(t), size(0), permissions(0777), mtime(Clock::now()) {}
+        // Adds a directory entry. Directory blocks are metadata, so the entry is written through the journal.
+        bool link(Txn& tx, uint32_t dir, std::string_view name, uint32_t ino, FileType type) {
+            DiskInode& d = inode(tx, dir);
+            uint64_t pos = d.size;
+            // A relocated directory gets room to double, so one growing entry by entry moves O(log n) times
+            if (!grow(tx, d, pos + sizeof(DiskDirent)) && !relocate(tx, d, 2 * (pos + sizeof(DiskDirent)))) return false;
+
+            DiskDirent e{};
+            e.ino = ino;
+            e.name_len = static_cast<uint8_t>(name.size());
+            e.type = static_cast<uint8_t>(static_cast<int>(type) + 1);
+            std::memcpy(e.name, name.data(), name.size());
+            for_each_run(d, pos, sizeof(e), [&](uint64_t at, uint64_t) {
+                std::memcpy(tx.block(static_cast<uint32_t>(at / kBlockSize)) + at % kBlockSize, &e, sizeof(e));
+            });
+            d.size = pos + sizeof(DiskDirent);
+            d.mtime_ns = wall_now();
+            return true;
+        }
     };
 
+    // Path resolution runs under an EpochGuard and returns raw inode pointers: inodes are owned by
+    // their parent's children map (and pinned by any dentry naming them) and are never unlinked.
     class VirtualFileSystem {
         std::shared_ptr<Inode> root_;
         std::atomic<uint64_t> inode_counter_{1};
+        std::pmr::memory_resource* data_resource_; // File contents; buddy blocks by default
+        DentryCache dcache_;
+        std::unique_ptr<VfsImage> image_;
 
     public:
-        VirtualFileSystem() {
+        // Longest name an image directory entry holds. Enforced with or without an image, so a
+        // tree that works in memory also persists.
+        static constexpr size_t kMaxName = VfsImage::kMaxName;
+
+        explicit VirtualFileSystem(std::pmr::memory_resource* data_resource = &BuddyAllocator::get())
+            : data_resource_(data_resource) {
             root_ = std::make_shared<Inode>(0, FileType::DIRECTORY);
         }
 
+        // Backs the whole tree with `image`; everything created afterwards is persisted. Nothing is
+        // read here: directories and files load from the image the first time they are touched.
+        void attach_image(std::unique_ptr<VfsImage> image) {
+            LEV_ASSERT(root_->children.empty(), "VFS: image attached to a populated tree");
+            image_ = std::move(image);
+            root_->disk_ino = VfsImage::kRootIno;
+            root_->loaded.store(false, std::memory_order_release);
+        }
+
+        VfsImage* image() { return image_.get(); }
+
         std::shared_ptr<Inode> create_file(const std::string& path, const std::string& content = "") {
+            EpochGuard epoch;
             auto [dir, name] = resolve_parent(path);
-            if (!dir) return nullptr;
+            if (!dir || dir->type != FileType::DIRECTORY || name.size() > kMaxName) return nullptr;
 
             SpinGuard g(dir->lock);
+            load_children_locked(*dir);
             if (dir->children.contains(name)) return nullptr; // Exists
 
+            uint32_t ino = 0;
+            if (dir->disk_ino && !(ino = image_->create(dir->disk_ino, name, FileType::REGULAR, bytes_of(content)))) return nullptr;
+
             auto file = std::make_shared<Inode>(inode_counter_++, FileType::REGULAR);
-            file->data.assign(content.begin(), content.end());
-            file->size = content.size();
-            dir->children[name] = file;
+            file->disk_ino = ino;
+            append_locked(*file, bytes_of(content)); // Not yet published, so nobody else can see it
+            dir->children.emplace(std::string(name), file);
+            publish_locked(dir, name, file);
             
-            LOG_TRACE("[VFS] Created file: {} (Size: {})", path, file->size);
+            LOG_TRACE("[VFS] Created file: {} (Size: {})", path, content.size());
             return file;
         }
 
         std::string read_file(const std::string& path) {
-            auto node = resolve_path(path);
-            if (!node || node->type != FileType::REGULAR) return "";
+            return read(path, 0, std::numeric_limits<uint64_t>::max()).to_string();
+        }
+
+        // Zero-copy read of [offset, offset + len), clamped to EOF
+        FileView read(const std::string& path, uint64_t offset, uint64_t len) {
+            EpochGuard epoch;
+            Inode* node = resolve_path(path);
+            if (!node || node->type != FileType::REGULAR) return {};
+            if (!node->loaded.load(std::memory_order_acquire)) {
+                SpinGuard g(node->lock);
+                load_contents_locked(*node);
+            }
+            return FileView(node->snapshot(), offset, len);
+        }
+
+        // Copy-on-write overwrite of [offset, offset + data.size()); a gap past EOF is zero-filled
+        bool write(const std::string& path, uint64_t offset, std::span<const uint8_t> data) {
+            EpochGuard epoch;
+            Inode* node = resolve_path(path);
+            if (!node || node->type != FileType::REGULAR) return false;
             SpinGuard g(node->lock);
-            return std::string(node->data.begin(), node->data.end());
+            load_contents_locked(*node);
+            if (node->disk_ino && !image_->write(node->disk_ino, offset, data)) return false;
+            write_locked(*node, offset, data);
+            return true;
+        }
+
+        bool write(const std::string& path, uint64_t offset, std::string_view data) {
+            return write(path, offset, bytes_of(data));
+        }
+
+        bool append(const std::string& path, std::span<const uint8_t> data) {
+            EpochGuard epoch;
+            Inode* node = resolve_path(path);
+            if (!node || node->type != FileType::REGULAR) return false;
+            SpinGuard g(node->lock);
+            load_contents_locked(*node);
+            if (node->disk_ino && !image_->append(node->disk_ino, data)) return false;
+            append_locked(*node, data);
+            return true;
+        }
+
+        bool append(const std::string& path, std::string_view data) {
+            return append(path, bytes_of(data));
         }
 
         bool mkdir(const std::string& path) {
+            EpochGuard epoch;
             auto [dir, name] = resolve_parent(path);
-            if (!dir) return false;
+            if (!dir || dir->type != FileType::DIRECTORY || name.size() > kMaxName) return false;
             SpinGuard g(dir->lock);
+            load_children_locked(*dir);
             if (dir->children.contains(name)) return false;
-            
+
+            uint32_t ino = 0;
+            if (dir->disk_ino && !(ino = image_->create(dir->disk_ino, name, FileType::DIRECTORY))) return false;
+
             auto new_dir = std::make_shared<Inode>(inode_counter_++, FileType::DIRECTORY);
-            dir->children[name] = new_dir;
+            new_dir->disk_ino = ino;
+            dir->children.emplace(std::string(name), new_dir);
+            publish_locked(dir, name, new_dir);
             LOG_TRACE("[VFS] Created directory: {}", path);
             return true;
         }
 
         void list_dir(const std::string& path) {
-            auto node = resolve_path(path);
+            EpochGuard epoch;
+            Inode* node = resolve_path(path);
             if (!node || node->type != FileType::DIRECTORY) {
                 std::cout << "Invalid directory.\n";
                 return;
             }
             SpinGuard g(node->lock);
+            load_children_locked(*node);
             std::cout << "Listing " << path << ":\n";
             for (const auto& [name, inode] : node->children) {
                 std::cout << (inode->type == FileType::DIRECTORY ? "[DIR] " : "[FILE] ") 
-                          << name << "\tID:" << inode->id << "\tSize:" << inode->size << "\n";
+                          << name << "\tID:" << inode->id << "\tSize:" << inode->size.load() << "\n";
             }
         }
 
     private:
-        std::shared_ptr<Inode> resolve_path(const std::string& path) {
-            if (path == "/") return root_;
-            std::stringstream ss(path);
-            std::string segment;
-            auto curr = root_;
-            
-            while (std::getline(ss, segment, '/')) {
-                if (segment.empty()) continue;
-                SpinGuard g(curr->lock);
-                if (!curr->children.contains(segment)) return nullptr;
-                curr = curr->children[segment];
+        // Path components go in the calling thread's arena and are dropped with the request's scope.
+        // The views point into `path`.
+        static std::pmr::vector<std::string_view> split_path(std::string_view path, std::pmr::memory_resource* mr) {
+            std::pmr::vector<std::string_view> parts(mr);
+            size_t pos = 0;
+            while (pos < path.size()) {
+                size_t end = path.find('/', pos);
+                if (end == std::string_view::npos) end = path.size();
+                if (end > pos) parts.push_back(path.substr(pos, end - pos));
+                pos = end + 1;
+            }
+            return parts;
+        }
+
+        // Caller holds an EpochGuard
+        Inode* walk(std::span<const std::string_view> parts) {
+            Inode* curr = root_.get();
+            for (std::string_view segment : parts) {
+                if (curr->type != FileType::DIRECTORY) return nullptr;
+                curr = lookup(curr, segment);
+                if (!curr) return nullptr;
             }
             return curr;
         }
 
-        std::pair<std::shared_ptr<Inode>, std::string> resolve_parent(const std::string& path) {
-            size_t last_slash = path.find_last_of('/');
-            if (last_slash == std::string::npos) return {root_, path};
-            
-            std::string dir_path = path.substr(0, last_slash);
-            std::string file_name = path.substr(last_slash + 1);
-            if (dir_path.empty()) dir_path = "/";
-            
-            return {resolve_path(dir_path), file_name};
+        Inode* lookup(Inode* dir, std::string_view name) {
+            EpochGuard epoch; // Joins the caller's; inactive for threads without a slot
+            if (epoch.active()) {
+                if (const auto* d = dcache_.find(dir->id, name)) return d->inode.get();
+            }
+
+            // Miss: consult the directory and cache the answer, positive or negative, under its lock
+            SpinGuard g(dir->lock);
+            load_children_locked(*dir);
+            auto it = dir->children.find(name);
+            std::shared_ptr<Inode> child = it == dir->children.end() ? nullptr : it->second;
+            Inode* raw = child.get();
+            dcache_.insert(dir->id, name, std::move(child));
+            return raw;
+        }
+
+        // Children come in unloaded, with their size from the image, so listing a directory reads
+        // its entries and inodes but no file data
+        void load_children_locked(Inode& dir) {
+            if (dir.loaded.load(std::memory_order_relaxed)) return;
+            auto now = Clock::now();
+            auto wall = std::chrono::system_clock::now().time_since_epoch();
+            image_->for_each_entry(dir.disk_ino, [&](std::string_view name, uint32_t ino, const VfsImage::DiskInode& d) {
+                auto child = std::make_shared<Inode>(inode_counter_++, static_cast<FileType>(d.type - 1));
+                child->disk_ino = ino;
+                child->permissions = d.permissions;
+                child->mtime = now - std::chrono::duration_cast<Clock::duration>(wall - Nanoseconds(d.mtime_ns));
+                if (child->type == FileType::REGULAR) child->size.store(d.size, std::memory_order_relaxed);
+                child->loaded.store(false, std::memory_order_relaxed);
+                dir.children.emplace(std::string(name), std::move(child));
+            });
+            dir.loaded.store(true, std::memory_order_release);
+        }
+
+        // Copies the file's data out of the image into extents. Caller holds file.lock.
+        void load_contents_locked(Inode& file) {
+            if (file.loaded.load(std::memory_order_relaxed)) return;
+            auto next = std::make_shared<FileExtents>(data_resource_);
+            image_->read(file.disk_ino, [&](std::span<const uint8_t> run) {
+                emit_extents(*next, next->size, run);
+                next->size += run.size();
+            });
+            {
+                SpinGuard g(file.contents_lock);
+                file.contents = std::move(next);
+            }
+            file.loaded.store(true, std::memory_order_release);
+        }
+
+        static std::span<const uint8_t> bytes_of(std::string_view s) {
+            return {reinterpret_cast<const uint8_t*>(s.data()), s.size()};
+        }
+
+        // New extents for `data` at file offset `at`. Capacity follows the file's size, so a run of
+        // small appends shares extents instead of getting one each.
+        void emit_extents(FileExtents& out, uint64_t at, std::span<const uint8_t> data) {
+            while (!data.empty()) {
+                size_t want = std::max<size_t>(data.size(), static_cast<size_t>(at / 8));
+                size_t cap = std::clamp(std::bit_ceil(want), Extent::kMinCapacity, Extent::kMaxCapacity);
+                auto ext = std::allocate_shared<Extent>(std::pmr::polymorphic_allocator<Extent>(data_resource_), data_resource_, cap);
+                size_t n = std::min(cap, data.size());
+                std::memcpy(ext->bytes, data.data(), n);
+                ext->filled = static_cast<uint32_t>(n);
+                out.refs.push_back({std::move(ext), 0, static_cast<uint32_t>(n), at});
+                at += n;
+                data = data.subspan(n);
+            }
+        }
+
+        // Caller holds file.lock (or the file is not yet published)
+        void append_locked(Inode& file, std::span<const uint8_t> data) {
+            auto cur = file.contents; // Writers hold file.lock, so no one else swaps it
+            auto next = std::make_shared<FileExtents>(data_resource_);
+            if (cur) {
+                next->refs = cur->refs;
+                next->size = cur->size;
+            }
+            // Fill the last extent's tail in place when this file's data ends exactly at its watermark
+            if (!next->refs.empty()) {
+                ExtentRef& last = next->refs.back();
+                Extent& e = *last.extent;
+                if (last.offset + last.length == e.filled && e.filled < e.capacity) {
+                    size_t n = std::min<size_t>(e.capacity - e.filled, data.size());
+                    std::memcpy(e.bytes + e.filled, data.data(), n);
+                    e.filled += static_cast<uint32_t>(n);
+                    last.length += static_cast<uint32_t>(n);
+                    next->size += n;
+                    data = data.subspan(n);
+                }
+            }
+            emit_extents(*next, next->size, data);
+            next->size += data.size();
+            publish_contents(file, std::move(next));
+        }
+
+        // Caller holds file.lock. Untouched runs keep their extents; only the written bytes are copied.
+        void write_locked(Inode& file, uint64_t offset, std::span<const uint8_t> data) {
+            auto cur = file.contents;
+            uint64_t size = cur ? cur->size : 0;
+            if (offset > size) {
+                std::vector<uint8_t> zeros(offset - size, 0);
+                append_locked(file, zeros);
+                cur = file.contents;
+                size = offset;
+            }
+            if (offset == size) return append_locked(file, data);
+
+            uint64_t end = offset + data.size();
+            auto next = std::make_shared<FileExtents>(data_resource_);
+            next->refs.reserve(cur->refs.size() + data.size() / Extent::kMaxCapacity + 3);
+
+            size_t i = cur->locate(offset);
+            next->refs.insert(next->refs.end(), cur->refs.begin(), cur->refs.begin() + static_cast<ptrdiff_t>(i));
+            const ExtentRef& head = cur->refs[i];
+            if (head.file_offset < offset) {
+                next->refs.push_back({head.extent, head.offset, static_cast<uint32_t>(offset - head.file_offset), head.file_offset});
+            }
+            emit_extents(*next, offset, data);
+            if (end < size) {
+                size_t j = cur->locate(end);
+                const ExtentRef& tail = cur->refs[j];
+                uint32_t cut = static_cast<uint32_t>(end - tail.file_offset);
+                next->refs.push_back({tail.extent, tail.offset + cut, tail.length - cut, end});
+                next->refs.insert(next->refs.end(), cur->refs.begin() + static_cast<ptrdiff_t>(j) + 1, cur->refs.end());
+            }
+            next->size = std::max(size, end);
+            publish_contents(file, std::move(next));
+        }
+
+        static void publish_contents(Inode& file, std::shared_ptr<FileExtents> next) {
+            size_t size = next->size;
+            std::shared_ptr<const FileExtents> old;
+            {
+                SpinGuard g(file.contents_lock);
+                old = std::exchange(file.contents, std::move(next));
+            }
+            file.size.store(size, std::memory_order_relaxed); // `old` is released outside the lock
+            file.mtime = Clock::now();
+        }
+
+        // New child under dir->lock: overwrite any negative entry for its name
+        void publish_locked(Inode* dir, std::string_view name, std::shared_ptr<Inode> child) {
+            dcache_.insert(dir->id, name, std::move(child));
+        }
+
+        Inode* resolve_path(std::string_view path) {
+            ArenaScope scope;
+            auto parts = split_path(path, scope.resource());
+            return walk(parts);
+        }
+
+        // Parent directory and final component; the name views into `path`
+        std::pair<Inode*, std::string_view> resolve_parent(std::string_view path) {
+            ArenaScope scope;
+            auto parts = split_path(path, scope.resource());
+            if (parts.empty()) return {nullptr, {}};
+            std::string_view name = parts.back();
+            parts.pop_back();
+            return {walk(parts), name};
         }
     };
 
@@ -591,7 +2855,7 @@ namespace Leviathan {
 // SECTION 6: NETWORK SUBSYSTEM (MOCK RING BUFFER STACK)
 // =====================================================================================================================
 
-    struct Packet {
+    struct alignas(LEVIATHAN_CACHELINE) Packet {
         uint64_t id;
         uint32_t src_ip;
         uint32_t dest_ip;
@@ -601,42 +2865,284 @@ namespace Leviathan {
         size_t size;
     };
 
-    class NetworkInterface {
-        std::array<Packet, LEVIATHAN_NET_RING_SIZE> rx_ring_;
-        std::atomic<size_t> rx_head_{0};
-        std::atomic<size_t> rx_tail_{0};
-        SpinLock ring_lock_;
+    // Descriptor for a buffer in a PacketPool. Copying one copies the reference, never the packet.
+    struct PacketRef {
+        Packet* packet;
+
+        Packet* operator->() const { return packet; }
+        std::span<const uint8_t> payload() const { return {packet->payload, packet->size}; }
+    };
+
+    enum class RingSync : uint8_t { SINGLE, MULTI };
+
+    // --- Descriptor Ring ---
+    // Bounded ring of trivially copyable descriptors with burst enqueue and dequeue, after DPDK's
+    // rte_ring. Each side has a head (slots claimed) and a tail (slots published). A burst claims
+    // its slots with one CAS on its side's head, or a plain store when that side is SINGLE, copies
+    // the descriptors, then waits for earlier claimers on the same side before moving the tail past
+    // its slots. No locks, and one atomic round trip per burst instead of one per descriptor.
+    template <typename T>
+    class DescriptorRing {
+        static_assert(std::is_trivially_copyable_v<T>, "DescriptorRing holds plain descriptors");
+
+        struct alignas(LEVIATHAN_CACHELINE) Cursor {
+            std::atomic<uint64_t> head{0};
+            std::atomic<uint64_t> tail{0};
+        };
+
+        std::pmr::vector<T> slots_;
+        const uint64_t mask_;
+        const RingSync producers_;
+        const RingSync consumers_;
+        Cursor prod_;
+        Cursor cons_;
 
     public:
-        void receive_packet(const std::string& data) {
-            SpinGuard g(ring_lock_);
-            size_t next_head = (rx_head_ + 1) % LEVIATHAN_NET_RING_SIZE;
-            if (next_head == rx_tail_) {
-                LOG_WARN("[NET] RX Ring Buffer Overflow! Dropping packet.");
-                return;
+        DescriptorRing(size_t capacity, RingSync producers, RingSync consumers,
+                       std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : slots_(std::bit_ceil(capacity), mr), mask_(slots_.size() - 1), producers_(producers), consumers_(consumers) {}
+
+        DescriptorRing(const DescriptorRing&) = delete;
+        DescriptorRing& operator=(const DescriptorRing&) = delete;
+
+        size_t capacity() const { return slots_.size(); }
+
+        size_t size() const {
+            uint64_t cons = cons_.tail.load(std::memory_order_acquire);
+            return prod_.tail.load(std::memory_order_acquire) - cons;
+        }
+
+        // Enqueues the longest prefix of `items` that fits; returns its length
+        size_t enqueue_burst(std::span<const T> items) {
+            uint64_t head;
+            uint64_t n = claim(prod_, producers_, items.size(), head, [&](uint64_t h) {
+                return capacity() - (h - cons_.tail.load(std::memory_order_acquire));
+            });
+            for (uint64_t i = 0; i < n; ++i) slots_[(head + i) & mask_] = items[i];
+            if (n) publish(prod_, producers_, head, n);
+            return n;
+        }
+
+        size_t dequeue_burst(std::span<T> out) {
+            uint64_t head;
+            uint64_t n = claim(cons_, consumers_, out.size(), head, [&](uint64_t h) {
+                return prod_.tail.load(std::memory_order_acquire) - h;
+            });
+            for (uint64_t i = 0; i < n; ++i) out[i] = slots_[(head + i) & mask_];
+            if (n) publish(cons_, consumers_, head, n);
+            return n;
+        }
+
+    private:
+        template <typename Available>
+        static uint64_t claim(Cursor& c, RingSync sync, uint64_t want, uint64_t& head, Available&& available) {
+            head = c.head.load(std::memory_order_relaxed);
+            while (true) {
+                uint64_t n = std::min(want, available(head));
+                if (n == 0) return 0;
+                if (sync == RingSync::SINGLE) {
+                    c.head.store(head + n, std::memory_order_relaxed);
+                    return n;
+                }
+                if (c.head.compare_exchange_weak(head, head + n, std::memory_order_relaxed)) return n;
             }
+        }
 
-            Packet& p = rx_ring_[rx_head_];
-            p.id = XorShift64::next();
-            p.size = std::min(data.size(), sizeof(p.payload));
-            std::memcpy(p.payload, data.data(), p.size);
-            
-            rx_head_ = next_head;
-            LOG_TRACE("[NET] Received Packet ID:{}", p.id);
+        // The acquire wait chains each claimer's copies into the release that publishes the next
+        static void publish(Cursor& c, RingSync sync, uint64_t head, uint64_t n) {
+            if (sync == RingSync::MULTI) {
+                while (c.tail.load(std::memory_order_acquire) != head) std::this_thread::yield();
+            }
+            c.tail.store(head + n, std::memory_order_release);
+        }
+    };
+
+    // --- Packet Buffer Pool ---
+    // A fixed set of buffers carved from one allocation. Free buffers are descriptors in an MPMC
+    // ring, fronted by a small cache per thread slot (as in DPDK's mempool): most allocs and frees
+    // touch only the caller's cache, which refills from or flushes to the ring a whole cache at a
+    // time. Up to kCacheSize buffers per slot can sit in caches, so size the pool with that slack.
+    class PacketPool {
+    public:
+        static constexpr size_t kCacheSize = 64;
+
+    private:
+        struct alignas(LEVIATHAN_CACHELINE) Cache {
+            std::atomic<size_t> count{0}; // Owner writes only; atomic so available() may read it
+            PacketRef refs[kCacheSize];
+        };
+
+        std::pmr::memory_resource* mr_;
+        size_t count_;
+        Packet* buffers_;
+        DescriptorRing<PacketRef> free_;
+        std::array<Cache, LEVIATHAN_MAX_THREADS> caches_;
+
+    public:
+        PacketPool(size_t count, std::pmr::memory_resource* mr)
+            : mr_(mr), count_(count),
+              buffers_(static_cast<Packet*>(mr->allocate(count * sizeof(Packet), alignof(Packet)))),
+              free_(count, RingSync::MULTI, RingSync::MULTI, mr) {
+            for (size_t i = 0; i < count_; ++i) {
+                PacketRef ref{::new (&buffers_[i]) Packet{}};
+                free_.enqueue_burst({&ref, 1});
+            }
+        }
+
+        ~PacketPool() { mr_->deallocate(buffers_, count_ * sizeof(Packet), alignof(Packet)); }
+
+        PacketPool(const PacketPool&) = delete;
+        PacketPool& operator=(const PacketPool&) = delete;
+
+        // Takes up to out.size() buffers; fewer only when the pool runs dry
+        size_t alloc_bulk(std::span<PacketRef> out) {
+            size_t slot = ThreadSlot::index();
+            if (slot == ThreadSlot::kNoSlot) [[unlikely]] return free_.dequeue_burst(out);
+
+            Cache& c = caches_[slot];
+            size_t have = c.count.load(std::memory_order_relaxed);
+            if (have < out.size()) have += free_.dequeue_burst(std::span(c.refs + have, kCacheSize - have));
+            size_t n = std::min(out.size(), have);
+            std::copy_n(c.refs + have - n, n, out.begin());
+            c.count.store(have - n, std::memory_order_relaxed);
+            if (n < out.size()) n += free_.dequeue_burst(out.subspan(n)); // Burst larger than the cache
+            return n;
+        }
+
+        void free_bulk(std::span<const PacketRef> refs) {
+            size_t slot = ThreadSlot::index();
+            if (slot == ThreadSlot::kNoSlot) [[unlikely]] return give_back(refs);
+
+            Cache& c = caches_[slot];
+            size_t have = c.count.load(std::memory_order_relaxed);
+            if (have + refs.size() > kCacheSize) {
+                give_back(std::span<const PacketRef>(c.refs, have));
+                have = 0;
+                if (refs.size() > kCacheSize) {
+                    c.count.store(0, std::memory_order_relaxed);
+                    return give_back(refs);
+                }
+            }
+            std::copy(refs.begin(), refs.end(), c.refs + have);
+            c.count.store(have + refs.size(), std::memory_order_relaxed);
+        }
+
+        size_t available() const {
+            size_t n = free_.size();
+            for (const Cache& c : caches_) n += c.count.load(std::memory_order_relaxed);
+            return n;
+        }
+        size_t capacity() const { return count_; }
+
+    private:
+        void give_back(std::span<const PacketRef> refs) {
+            size_t n = free_.enqueue_burst(refs);
+            LEV_ASSERT(n == refs.size(), "PacketPool: more buffers freed than allocated");
+        }
+    };
+
+    // --- Network Interface ---
+    // Descriptor rings over a fixed buffer pool, shaped like a NIC and its driver. The device side
+    // takes buffers, fills them (the only copy a packet gets) and posts them on the RX ring. The
+    // stack takes bursts with rx_batch() and owns those buffers until it release()s them or passes
+    // them to tx_batch(); the device drains TX and returns the buffers to the pool in bulk. Each
+    // ring's ends are SINGLE or MULTI to match how many threads act as device and as stack.
+    class NetworkInterface {
+    public:
+        static constexpr size_t kBurst = 32;
+
+        struct Options {
+            size_t ring_size = LEVIATHAN_NET_RING_SIZE;
+            RingSync device = RingSync::MULTI; // Threads posting RX and draining TX
+            RingSync stack = RingSync::MULTI;  // Threads calling rx_batch and tx_batch
+        };
+
+        NetworkInterface() : NetworkInterface(Options{}) {}
+
+        // Buffers and rings come from `buffers`, the shared buddy pool by default
+        explicit NetworkInterface(Options opts, std::pmr::memory_resource* buffers = &BuddyAllocator::get())
+            : pool_(opts.ring_size * 2 + LEVIATHAN_MAX_THREADS * PacketPool::kCacheSize, buffers),
+              rx_(opts.ring_size, opts.device, opts.stack, buffers),
+              tx_(opts.ring_size, opts.stack, opts.device, buffers) {}
+
+        // Device side: fills a buffer per frame and posts them. Returns how many were posted, a
+        // prefix of `frames`; the rest are dropped when buffers or RX slots run out.
+        size_t receive_batch(std::span<const std::string_view> frames) {
+            std::array<PacketRef, kBurst> refs;
+            size_t posted = 0;
+            size_t dropped = 0;
+            while (!frames.empty()) {
+                size_t want = std::min(kBurst, frames.size());
+                size_t n = pool_.alloc_bulk(std::span(refs.data(), want));
+                for (size_t i = 0; i < n; ++i) fill(refs[i], frames[i]);
+                size_t sent = rx_.enqueue_burst(std::span<const PacketRef>(refs.data(), n));
+                pool_.free_bulk(std::span<const PacketRef>(refs.data() + sent, n - sent));
+                posted += sent;
+                if (sent < want) {
+                    dropped = frames.size() - sent;
+                    break;
+                }
+                frames = frames.subspan(want);
+            }
+            rx_packets_.fetch_add(posted, std::memory_order_relaxed);
+            // Warn once; under overload a warning per burst would be a second flood. netstat has the count.
+            if (dropped && rx_dropped_.fetch_add(dropped, std::memory_order_relaxed) == 0) {
+                LOG_WARN("[NET] RX Ring Buffer Overflow! Dropping packets.");
+            }
+            return posted;
+        }
+
+        bool receive_packet(std::string_view data) {
+            return receive_batch(std::span(&data, 1)) == 1;
         }
 
-        std::optional<Packet> pop_packet() {
-            SpinGuard g(ring_lock_);
-            if (rx_head_ == rx_tail_) return std::nullopt;
+        // Stack side: takes up to out.size() received packets
+        size_t rx_batch(std::span<PacketRef> out) { return rx_.dequeue_burst(out); }
+
+        // Empty buffers for packets the stack builds itself
+        size_t alloc_batch(std::span<PacketRef> out) { return pool_.alloc_bulk(out); }
 
-            Packet p = rx_ring_[rx_tail_];
-            rx_tail_ = (rx_tail_ + 1) % LEVIATHAN_NET_RING_SIZE;
-            return p;
+        void release(std::span<const PacketRef> pkts) { pool_.free_bulk(pkts); }
+
+        // Queues packets for transmit. The device owns the accepted prefix; the caller keeps the rest.
+        size_t tx_batch(std::span<const PacketRef> pkts) { return tx_.enqueue_burst(pkts); }
+
+        // Device side: sends everything queued, returning buffers to the pool a burst at a time
+        size_t drain_tx() {
+            std::array<PacketRef, kBurst> sent;
+            size_t packets = 0;
+            uint64_t bytes = 0;
+            while (size_t n = tx_.dequeue_burst(sent)) {
+                for (size_t i = 0; i < n; ++i) bytes += sent[i]->size;
+                pool_.free_bulk(std::span<const PacketRef>(sent.data(), n));
+                packets += n;
+            }
+            tx_packets_.fetch_add(packets, std::memory_order_relaxed);
+            tx_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+            return packets;
         }
 
         void stats() {
-            size_t count = (rx_head_ >= rx_tail_) ? (rx_head_ - rx_tail_) : (LEVIATHAN_NET_RING_SIZE - rx_tail_ + rx_head_);
-            LOG_INFO("[NET] RX Queue Depth: {}", count);
+            LOG_INFO("[NET] RX Queue Depth: {}", rx_.size());
+            LOG_INFO("[NET] rx:{} dropped:{} tx:{} ({} B) free buffers:{}/{}", rx_packets_.load(std::memory_order_relaxed),
+                     rx_dropped_.load(std::memory_order_relaxed), tx_packets_.load(std::memory_order_relaxed),
+                     tx_bytes_.load(std::memory_order_relaxed), pool_.available(), pool_.capacity());
+        }
+
+    private:
+        PacketPool pool_;
+        DescriptorRing<PacketRef> rx_;
+        DescriptorRing<PacketRef> tx_;
+        std::atomic<uint64_t> rx_packets_{0};
+        std::atomic<uint64_t> rx_dropped_{0};
+        std::atomic<uint64_t> tx_packets_{0};
+        std::atomic<uint64_t> tx_bytes_{0};
+
+        static void fill(PacketRef ref, std::string_view frame) {
+            Packet& p = *ref.packet;
+            p.id = XorShift64::next();
+            p.size = std::min(frame.size(), sizeof(p.payload));
+            std::memcpy(p.payload, frame.data(), p.size);
         }
     };
 
@@ -653,9 +3159,15 @@ namespace Leviathan {
         Priority priority;
         TaskState state;
         std::function<void()> work;
-        std::vector<TaskID> dependencies;
+
+        // Dependency edges live in a per-task arena: inline for the usual handful, and released
+        // with the task in one step rather than per vector.
+        alignas(std::max_align_t) std::array<std::byte, 256> arena_buffer;
+        ArenaAllocator arena;
+
+        std::pmr::vector<TaskID> dependencies;
         std::atomic<uint32_t> unsatisfied_deps{0};
-        std::vector<TaskID> dependents;
+        std::pmr::vector<TaskID> dependents;
         TimePoint created_at;
         uint64_t cpu_time_ns{0};
         
@@ -663,7 +3175,9 @@ namespace Leviathan {
         std::array<uint64_t, 16> registers; 
 
         TaskContext(TaskID i, Priority p, std::function<void()> w)
-            : id(i), priority(p), state(TaskState::PENDING), work(std::move(w)), created_at(Clock::now()) {}
+            : id(i), priority(p), state(TaskState::PENDING), work(std::move(w)),
+              arena(arena_buffer.data(), arena_buffer.size(), 1024),
+              dependencies(&arena), dependents(&arena), created_at(Clock::now()) {}
     };
 
     class TaskGraph {
@@ -867,23 +3381,39 @@ namespace Leviathan {
             }
             else if (action == "touch") {
                 std::string path; ss >> path;
-                vfs_.create_file(path, "Empty File");
+                std::string_view name = std::string_view(path).substr(path.find_last_of('/') + 1);
+                if (name.size() > VirtualFileSystem::kMaxName) {
+                    std::cout << "Name too long (max " << VirtualFileSystem::kMaxName << " characters).\n";
+                } else {
+                    vfs_.create_file(path, "Empty File");
+                }
             }
             else if (action == "cat") {
                 std::string path; ss >> path;
                 std::cout << vfs_.read_file(path) << "\n";
             }
+            else if (action == "append") {
+                std::string path, text; ss >> path;
+                std::getline(ss >> std::ws, text);
+                if (!vfs_.append(path, text + "\n")) std::cout << "No such file.\n";
+            }
             else if (action == "netstat") {
                 net_.stats();
             }
             else if (action == "dmesg") {
                 KernelLogger::get().dump();
             }
+            else if (action == "meminfo") {
+                meminfo();
+            }
+            else if (action == "df") {
+                df();
+            }
             else if (action == "panic") {
                 LEV_ASSERT(false, "User induced panic via CLI");
             }
             else if (action == "help") {
-                std::cout << "Available: ls, touch, cat, netstat, dmesg, panic, exit\n";
+                std::cout << "Available: ls, touch, cat, append, netstat, dmesg, meminfo, df, panic, exit\n";
             }
             else if (action == "exit") {
                 active_ = false;
@@ -893,6 +3423,33 @@ namespace Leviathan {
                 std::cout << "Unknown command. Type 'help'.\n";
             }
         }
+
+    private:
+        static void meminfo() {
+            SlabStats slab = SizeClassSlab::get().stats();
+            std::cout << std::format("[SLAB]  objects:{} bytes:{} spans:{} resident:{} pg retained:{} pg frag:{:.2f}\n",
+                                     slab.objects_used, slab.bytes_used, slab.spans, slab.pages_resident,
+                                     slab.pages_retained, slab.fragmentation);
+            BuddyStats buddy = BuddyAllocator::get().stats();
+            std::cout << std::format("[BUDDY] allocated:{} requested:{} free:{} largest:{} int-frag:{:.2f} ext-frag:{:.2f}\n",
+                                     buddy.bytes_allocated, buddy.bytes_requested, buddy.bytes_free, buddy.largest_free,
+                                     buddy.internal_fragmentation, buddy.external_fragmentation);
+            std::cout << "[BUDDY] free blocks by order:";
+            for (size_t n : buddy.free_blocks) std::cout << " " << n;
+            std::cout << "\n";
+        }
+
+        void df() {
+            VfsImage* image = vfs_.image();
+            if (!image) {
+                std::cout << "No image mounted.\n";
+                return;
+            }
+            VfsImageStats st = image->stats();
+            std::cout << std::format("[IMG] blocks free:{}/{} inodes free:{}/{} commits:{} journaled blocks:{} copied blocks:{} replayed:{} mount:{:.3f} ms\n",
+                                     st.blocks_free, st.blocks_total, st.inodes_free, st.inodes_total, st.commits,
+                                     st.journal_blocks, st.copied_blocks, st.replayed ? "yes" : "no", st.mount_ms);
+        }
     };
 
 // =====================================================================================================================
@@ -910,19 +3467,31 @@ namespace Leviathan {
         std::atomic<TaskID> id_gen_{1};
 
     public:
-        LeviathanKernel() {
+        // An empty image_path keeps the VFS in memory only
+        explicit LeviathanKernel(const std::filesystem::path& image_path = {}) {
             LOG_INFO("Bootstrapping LEVIATHAN SENTINEL CORE v3.0 (THE BEHEMOTH)...");
             
             // Initialize Subsystems
             vfs_ = std::make_unique<VirtualFileSystem>();
+            if (image_path.empty()) {
+                LOG_INFO("[IMG] No image given (--image <path>); the VFS will not persist");
+            } else if (auto image = VfsImage::open(image_path)) {
+                VfsImageStats st = image->stats();
+                LOG_INFO("[IMG] Mounted {} in {:.3f} ms ({} of {} inodes used)", image_path.string(), st.mount_ms,
+                         st.inodes_total - st.inodes_free - 2, st.inodes_total - 2);
+                vfs_->attach_image(std::move(image));
+            } else {
+                LOG_WARN("[IMG] Cannot mount {}; the VFS will not persist", image_path.string());
+            }
             net_ = std::make_unique<NetworkInterface>();
             shell_ = std::make_unique<KernelShell>(*vfs_, *net_);
             exec_ = std::make_unique<ExecutionEngine>(std::thread::hardware_concurrency(), scheduler_, graph_);
 
-            // Mount initial VFS points
+            // Mount initial VFS points; with an image these exist already after the first boot
             vfs_->mkdir("/sys");
             vfs_->mkdir("/proc");
             vfs_->mkdir("/dev");
+            vfs_->mkdir("/etc");
             vfs_->create_file("/etc/motd", "Welcome to Leviathan v3.0");
 
             // Start Shell
@@ -958,13 +3527,33 @@ namespace Leviathan {
                 }
             });
 
-            // 3. Network Simulation
+            // 3. Network Simulation: the device receives pings, the stack turns them around in place
             submit_task(Priority::REALTIME, [this]{
                 for(int i=0; i<50; ++i) {
                     net_->receive_packet("PING_PACKET_PAYLOAD_" + std::to_string(i));
                     std::this_thread::sleep_for(Microseconds(500));
                 }
             });
+            submit_task(Priority::REALTIME, [this]{
+                std::array<PacketRef, NetworkInterface::kBurst> burst;
+                size_t echoed = 0;
+                for (int idle = 0; echoed < 50 && idle < 200; ) {
+                    size_t n = net_->rx_batch(burst);
+                    if (n == 0) {
+                        ++idle;
+                        std::this_thread::sleep_for(Milliseconds(1));
+                        continue;
+                    }
+                    for (size_t i = 0; i < n; ++i) {
+                        std::swap(burst[i]->src_ip, burst[i]->dest_ip);
+                        std::swap(burst[i]->src_port, burst[i]->dest_port);
+                    }
+                    size_t queued = net_->tx_batch(std::span<const PacketRef>(burst.data(), n));
+                    net_->release(std::span<const PacketRef>(burst.data() + queued, n - queued));
+                    net_->drain_tx();
+                    echoed += n;
+                }
+            });
             
             // Wait loop
             std::this_thread::sleep_for(std::chrono::seconds(5));
@@ -975,16 +3564,398 @@ namespace Leviathan {
             }
         }
     };
+
+    // =================================================================================================================
+    // SECTION 12: BENCHMARKS
+    // =================================================================================================================
+
+    namespace Bench {
+        // Runs body(thread_index) on `threads` threads released together; returns wall seconds
+        template <typename Body>
+        double run_threads(size_t threads, Body&& body) {
+            std::barrier start(static_cast<std::ptrdiff_t>(threads + 1));
+            std::vector<std::jthread> pool;
+            for (size_t t = 0; t < threads; ++t) {
+                pool.emplace_back([&, t] {
+                    start.arrive_and_wait();
+                    body(t);
+                });
+            }
+            start.arrive_and_wait();
+            auto t0 = Clock::now();
+            pool.clear();
+            return std::chrono::duration<double>(Clock::now() - t0).count();
+        }
+
+        // Process resident set in KiB, or 0 where /proc is unavailable
+        inline size_t resident_kib() {
+            std::ifstream statm("/proc/self/statm");
+            size_t total = 0, resident = 0;
+            if (!(statm >> total >> resident)) return 0;
+            return resident * (LEVIATHAN_PAGE_SIZE / 1024);
+        }
+
+        // Bursty alloc/free per thread: the shape of task contexts churning through the scheduler.
+        // "locked" is the backend alone (one SpinLock round trip per call), "magazine" the cached path.
+        // The second table allocates a large burst, frees it, and shows how much comes back.
+        inline void slab() {
+            constexpr size_t kBurst = 64;
+            constexpr size_t kRounds = 20000;
+            std::cout << std::format("Slab allocator, {}-object bursts, {} rounds per thread\n", kBurst, kRounds);
+            std::cout << "threads    locked Mops/s  magazine Mops/s  speedup\n";
+
+            for (size_t threads : {1, 2, 4, 8}) {
+                auto measure = [&](bool cached) {
+                    SizeClassSlab backend;
+                    SlabAllocator<64> slab(backend);
+                    double secs = run_threads(threads, [&](size_t) {
+                        void* held[kBurst];
+                        for (size_t r = 0; r < kRounds; ++r) {
+                            for (size_t i = 0; i < kBurst; ++i) {
+                                held[i] = cached ? slab.allocate() : slab.allocate_uncached();
+                                static_cast<volatile uint8_t*>(held[i])[0] = static_cast<uint8_t>(i);
+                            }
+                            for (size_t i = 0; i < kBurst; ++i) {
+                                if (cached) slab.deallocate(held[i]);
+                                else slab.deallocate_uncached(held[i]);
+                            }
+                        }
+                    });
+                    LEV_ASSERT(slab.stats_used() == 0, "slab benchmark leaked objects");
+                    return static_cast<double>(threads * kRounds * kBurst * 2) / secs / 1e6;
+                };
+                double locked = measure(false);
+                double magazine = measure(true);
+                std::cout << std::format("{:>7}  {:>15.1f}  {:>15.1f}  {:>6.2f}x\n", threads, locked, magazine, magazine / locked);
+            }
+
+            constexpr size_t kBurstObjects = 200000;
+            std::cout << std::format("\nBurst of {} x 256 B objects, then freed\n", kBurstObjects);
+            std::cout << "span       phase   used   spans  resident pg  frag    RSS KiB\n";
+            for (bool huge : {false, true}) {
+                SizeClassSlab backend(SizeClassSlab::Options{.huge_pages = huge});
+                auto row = [&](const char* phase, const SlabStats& st) {
+                    std::cout << std::format("{:<9} {:>6} {:>6} {:>7} {:>12} {:>5.2f} {:>10}\n", huge ? "2 MiB" : "64 KiB", phase,
+                                             st.objects_used, st.spans, st.pages_resident, st.fragmentation, resident_kib());
+                };
+                size_t rss_before = resident_kib();
+                {
+                    SlabAllocator<256> slab(backend);
+                    std::vector<void*> held(kBurstObjects);
+                    for (auto& p : held) {
+                        p = slab.allocate();
+                        std::memset(p, 0xA5, 256);
+                    }
+                    row("peak", backend.stats());
+                    for (void* p : held) slab.deallocate(p);
+                    row("freed", slab.stats());
+                }
+                row("flushed", backend.stats());
+                std::cout << std::format("          retained {} spans, released {} so far, RSS delta {} KiB\n",
+                                         backend.stats().pages_retained, backend.stats().spans_released,
+                                         static_cast<int64_t>(resident_kib()) - static_cast<int64_t>(rss_before));
+            }
+        }
+
+        // Random transfers between a few hot counters: STM transactions against one mutex over all of
+        // them. The counters' total must survive either way.
+        inline void stm() {
+            constexpr size_t kCounters = 16;
+            constexpr size_t kTransfers = 200000;
+            std::cout << std::format("STM vs mutex, {} counters, {} transfers per thread\n", kCounters, kTransfers);
+            std::cout << "threads     mutex Mtx/s     STM Mtx/s  abort rate\n";
+
+            for (size_t threads : {1, 2, 4, 8}) {
+                std::array<uint64_t, kCounters> counters;
+                auto transfers = [&](auto&& move) {
+                    counters.fill(1000000);
+                    double secs = run_threads(threads, [&](size_t) {
+                        for (size_t i = 0; i < kTransfers; ++i) {
+                            uint64_t r = XorShift64::next();
+                            size_t from = r % kCounters;
+                            size_t to = (from + 1 + (r >> 32) % (kCounters - 1)) % kCounters;
+                            move(from, to);
+                        }
+                    });
+                    LEV_ASSERT(std::accumulate(counters.begin(), counters.end(), uint64_t{0}) == kCounters * 1000000,
+                               "STM benchmark lost an update");
+                    return static_cast<double>(threads * kTransfers) / secs / 1e6;
+                };
+
+                std::mutex mutex;
+                double locked = transfers([&](size_t from, size_t to) {
+                    std::lock_guard g(mutex);
+                    counters[from]--;
+                    counters[to]++;
+                });
+
+                STMManager& stm = STMManager::get();
+                STMStats before = stm.stats();
+                double transactional = transfers([&](size_t from, size_t to) {
+                    stm.atomically([&](STMTransaction& tx) {
+                        tx.write(counters[from], tx.read(counters[from]) - 1);
+                        tx.write(counters[to], tx.read(counters[to]) + 1);
+                    });
+                });
+                STMStats after = stm.stats();
+                uint64_t commits = after.commits - before.commits;
+                uint64_t aborts = after.aborts - before.aborts;
+                std::cout << std::format("{:>7}  {:>12.2f}  {:>12.2f}  {:>9.2f}%\n", threads, locked, transactional,
+                                         100.0 * static_cast<double>(aborts) / static_cast<double>(commits + aborts));
+            }
+
+            // TVar under contention: one writer, the rest readers, on a value with no default
+            // constructor. Every word derives from one seed, so a torn read shows up as a mismatch.
+            struct Stamp {
+                uint64_t words[4];
+                explicit Stamp(uint64_t seed) : words{seed, ~seed, seed * 3, seed ^ 0x5A5A5A5A5A5A5A5Aull} {}
+                bool consistent() const {
+                    return words[1] == ~words[0] && words[2] == words[0] * 3 && words[3] == (words[0] ^ 0x5A5A5A5A5A5A5A5Aull);
+                }
+            };
+            static_assert(!std::is_default_constructible_v<Stamp> && std::is_trivially_copyable_v<Stamp>);
+
+            constexpr uint64_t kWrites = 200000;
+            std::cout << std::format("\nTVar, 1 writer, {} writes\n", kWrites);
+            std::cout << "readers   Mreads/s   Mwrites/s  torn\n";
+            for (size_t readers : {1, 3, 7}) {
+                TVar<Stamp> var(Stamp(0));
+                std::atomic<bool> done{false};
+                std::atomic<uint64_t> reads{0}, torn{0};
+                double secs = run_threads(readers + 1, [&](size_t t) {
+                    if (t == 0) {
+                        for (uint64_t i = 1; i <= kWrites; ++i) var.write(Stamp(i));
+                        done.store(true, std::memory_order_release);
+                        return;
+                    }
+                    uint64_t n = 0, bad = 0;
+                    while (!done.load(std::memory_order_acquire)) {
+                        bad += !var.read().consistent();
+                        ++n;
+                    }
+                    reads.fetch_add(n);
+                    torn.fetch_add(bad);
+                });
+                LEV_ASSERT(torn.load() == 0 && var.read().words[0] == kWrites, "TVar returned a torn or stale value");
+                std::cout << std::format("{:>7}  {:>9.2f}  {:>10.2f}  {:>4}\n", readers, static_cast<double>(reads.load()) / secs / 1e6,
+                                         static_cast<double>(kWrites) / secs / 1e6, torn.load());
+            }
+        }
+
+        // Frames from producer threads through the RX ring to consumer threads, which read and
+        // release them. "locked" is the previous NIC design, kept here as the baseline: one
+        // SpinLock over a ring of Packet slots, copying each packet in and again out. "ring x1"
+        // passes descriptors one at a time, "ring x32" in bursts.
+        inline void net() {
+            constexpr size_t kPackets = 400000;
+            constexpr std::string_view kFrame = "PING_PACKET_PAYLOAD_0123456789_0123456789_0123456789";
+            std::cout << std::format("NIC RX path, {} packets per producer\n", kPackets);
+            std::cout << "prod x cons    locked Mpps  ring x1 Mpps  ring x32 Mpps\n";
+
+            struct LockedRing {
+                std::vector<Packet> slots = std::vector<Packet>(LEVIATHAN_NET_RING_SIZE);
+                size_t head = 0;
+                size_t tail = 0;
+                SpinLock lock;
+
+                bool push(std::string_view frame) {
+                    SpinGuard g(lock);
+                    size_t next = (head + 1) % slots.size();
+                    if (next == tail) return false;
+                    Packet& p = slots[head];
+                    p.id = XorShift64::next();
+                    p.size = std::min(frame.size(), sizeof(p.payload));
+                    std::memcpy(p.payload, frame.data(), p.size);
+                    head = next;
+                    return true;
+                }
+
+                std::optional<Packet> pop() {
+                    SpinGuard g(lock);
+                    if (head == tail) return std::nullopt;
+                    Packet p = slots[tail];
+                    tail = (tail + 1) % slots.size();
+                    return p;
+                }
+            };
+
+            for (size_t pairs : {1, 2}) {
+                size_t total = pairs * kPackets;
+                auto mpps = [&](double secs) { return static_cast<double>(total) / secs / 1e6; };
+                std::atomic<uint64_t> checksum{0};
+
+                LockedRing locked;
+                std::atomic<size_t> consumed{0};
+                double locked_secs = run_threads(pairs * 2, [&](size_t t) {
+                    if (t < pairs) {
+                        for (size_t i = 0; i < kPackets; ++i) {
+                            while (!locked.push(kFrame)) std::this_thread::yield();
+                        }
+                        return;
+                    }
+                    uint64_t sum = 0;
+                    while (consumed.load(std::memory_order_relaxed) < total) {
+                        if (auto p = locked.pop()) {
+                            sum += p->payload[p->size - 1];
+                            consumed.fetch_add(1, std::memory_order_relaxed);
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                    checksum.fetch_add(sum, std::memory_order_relaxed);
+                });
+
+                auto ring = [&](size_t burst) {
+                    RingSync sync = pairs == 1 ? RingSync::SINGLE : RingSync::MULTI;
+                    NetworkInterface nic(NetworkInterface::Options{.device = sync, .stack = sync});
+                    std::atomic<size_t> done{0};
+                    double secs = run_threads(pairs * 2, [&](size_t t) {
+                        if (t < pairs) {
+                            std::array<std::string_view, NetworkInterface::kBurst> frames;
+                            frames.fill(kFrame);
+                            for (size_t sent = 0; sent < kPackets;) {
+                                size_t n = nic.receive_batch(std::span(frames.data(), std::min(burst, kPackets - sent)));
+                                if (n == 0) std::this_thread::yield();
+                                sent += n;
+                            }
+                            return;
+                        }
+                        std::array<PacketRef, NetworkInterface::kBurst> refs;
+                        uint64_t sum = 0;
+                        while (done.load(std::memory_order_relaxed) < total) {
+                            size_t n = nic.rx_batch(std::span(refs.data(), burst));
+                            if (n == 0) {
+                                std::this_thread::yield();
+                                continue;
+                            }
+                            for (size_t i = 0; i < n; ++i) sum += refs[i].payload().back();
+                            nic.release(std::span<const PacketRef>(refs.data(), n));
+                            done.fetch_add(n, std::memory_order_relaxed);
+                        }
+                        checksum.fetch_add(sum, std::memory_order_relaxed);
+                    });
+                    return secs;
+                };
+                double single = ring(1);
+                double batched = ring(NetworkInterface::kBurst);
+                LEV_ASSERT(checksum.load() == 3 * total * static_cast<uint64_t>(kFrame.back()), "NIC benchmark lost packets");
+                std::cout << std::format("{:>4} x {:<4}  {:>11.2f}  {:>12.2f}  {:>13.2f}\n", pairs, pairs, mpps(locked_secs),
+                                         mpps(single), mpps(batched));
+            }
+        }
+
+        // A tree of empty files, 256 per directory, persisted to an image. "rebuild" is what boot
+        // costs without an image: creating the tree in memory. "mount" maps the image, and "first
+        // lookup" then reads one file, loading the two directories on its path. The image sits in
+        // the page cache, so this measures work done rather than the disk.
+        inline void mount() {
+            constexpr size_t kPerDir = 256;
+            std::cout << "VFS image mount vs tree size\n";
+            std::cout << "  files  image MiB  rebuild ms  mount ms  first lookup ms\n";
+
+            for (size_t files : {1000, 10000, 100000}) {
+                auto path = std::filesystem::temp_directory_path() / std::format("leviathan_bench_{}.img", files);
+                std::filesystem::remove(path);
+                size_t dirs = (files + kPerDir - 1) / kPerDir;
+                VfsImage::Options opts{.blocks = static_cast<uint32_t>(files / 16 + dirs * 8 + 256),
+                                       .inodes = static_cast<uint32_t>(files + dirs + 2), .sync = false};
+                auto file = [&](size_t i) { return std::format("/d{}/f{}", i / kPerDir, i); };
+                auto build = [&](VirtualFileSystem& vfs) {
+                    for (size_t d = 0; d < dirs; ++d) vfs.mkdir(std::format("/d{}", d));
+                    for (size_t i = 0; i < files; ++i) vfs.create_file(file(i));
+                    vfs.write(file(files / 2), 0, std::string_view("found"));
+                };
+
+                auto t0 = Clock::now();
+                {
+                    VirtualFileSystem vfs;
+                    build(vfs);
+                }
+                double rebuild_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+                {
+                    VirtualFileSystem vfs;
+                    vfs.attach_image(VfsImage::open(path, opts));
+                    build(vfs);
+                }
+
+                // Best of three: the first pass can stall on writeback of the pages the build dirtied
+                double mount_ms = 1e9, lookup_ms = 1e9;
+                for (int pass = 0; pass < 3; ++pass) {
+                    VirtualFileSystem vfs;
+                    t0 = Clock::now();
+                    vfs.attach_image(VfsImage::open(path, opts));
+                    auto t1 = Clock::now();
+                    LEV_ASSERT(vfs.read_file(file(files / 2)) == "found", "mount benchmark lost a file");
+                    auto t2 = Clock::now();
+                    mount_ms = std::min(mount_ms, std::chrono::duration<double, std::milli>(t1 - t0).count());
+                    lookup_ms = std::min(lookup_ms, std::chrono::duration<double, std::milli>(t2 - t1).count());
+                }
+                std::cout << std::format("{:>7}  {:>9.1f}  {:>10.1f}  {:>8.3f}  {:>15.3f}\n", files,
+                                         static_cast<double>(std::filesystem::file_size(path)) / (1 << 20), rebuild_ms,
+                                         mount_ms, lookup_ms);
+                std::filesystem::remove(path);
+            }
+
+            // 4 KiB overwrites inside an existing file, either the same block each time or a random
+            // one. "copied" is data blocks copied per write to keep the committed version intact.
+            constexpr size_t kWrites = 200;
+            std::cout << "\nVFS image 4 KiB overwrite vs file size\n";
+            std::cout << "  file KiB  pattern  us/write  copied blocks/write\n";
+            for (size_t kib : {64, 1024, 8192}) {
+                for (bool random : {false, true}) {
+                    auto path = std::filesystem::temp_directory_path() / "leviathan_bench_overwrite.img";
+                    std::filesystem::remove(path);
+                    auto image = VfsImage::open(path, {.blocks = static_cast<uint32_t>(kib / 2 + 512), .inodes = 64, .sync = false});
+                    std::vector<uint8_t> bytes(kib * 1024, 'a');
+                    uint32_t ino = image->create(VfsImage::kRootIno, "f", FileType::REGULAR, bytes);
+                    LEV_ASSERT(ino != 0, "overwrite benchmark could not create its file");
+
+                    std::span<const uint8_t> block(bytes.data(), VfsImage::kBlockSize);
+                    uint64_t copied = image->stats().copied_blocks;
+                    auto t0 = Clock::now();
+                    for (size_t i = 0; i < kWrites; ++i) {
+                        uint64_t at = random ? XorShift64::next() % (kib / 4) * VfsImage::kBlockSize : 0;
+                        LEV_ASSERT(image->write(ino, at, block), "overwrite benchmark ran out of space");
+                    }
+                    double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / kWrites;
+                    std::cout << std::format("{:>10}  {:>7}  {:>8.1f}  {:>19.1f}\n", kib, random ? "random" : "same", us,
+                                             static_cast<double>(image->stats().copied_blocks - copied) / kWrites);
+                    image.reset();
+                    std::filesystem::remove(path);
+                }
+            }
+        }
+    }
 }
 
 // =====================================================================================================================
 // MAIN ENTRY POINT
 // =====================================================================================================================
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string_view(argv[1]) == "--bench-slab") {
+        Leviathan::Bench::slab();
+        return 0;
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--bench-stm") {
+        Leviathan::Bench::stm();
+        return 0;
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--bench-net") {
+        Leviathan::Bench::net();
+        return 0;
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--bench-mount") {
+        Leviathan::Bench::mount();
+        return 0;
+    }
+    // Persistence is opt-in: without --image the VFS lives in memory only
+    std::filesystem::path image;
+    if (argc > 2 && std::string_view(argv[1]) == "--image") image = argv[2];
+
     // Catch-all exception handler for stability
     try {
-        Leviathan::LeviathanKernel kernel;
+        Leviathan::LeviathanKernel kernel(image);
         kernel.run_simulation();
     } catch (const std::exception& e) {
         std::cerr << "CRITICAL FAILURE: " << e.what() << "\n";